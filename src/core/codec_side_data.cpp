@@ -0,0 +1,227 @@
+#include "codec_side_data.hpp"
+#include "frame_source.hpp"
+#include <algorithm>
+#include <cmath>
+
+#ifdef SHARPCTL_HAS_FFMPEG
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+#include <libavutil/motion_vector.h>
+#include <libavutil/video_enc_params.h>
+}
+#endif
+
+namespace sharpctl {
+
+namespace {
+
+constexpr size_t kMinCandidates = 3;  // Prefilter never leaves a window with fewer frames
+constexpr float kQpMargin = 6.0f;  // H.264/HEVC quantizer step doubles every 6 QP
+
+}  // anonymous namespace
+
+float CodecSideData::motionAt(int frame) const {
+    if (frame < 0 || frame >= static_cast<int>(motion.size())) return -1.0f;
+    return motion[frame];
+}
+
+float CodecSideData::qpAt(int frame) const {
+    if (frame < 0 || frame >= static_cast<int>(qp.size())) return -1.0f;
+    return qp[frame];
+}
+
+std::vector<int> CodecSideData::prefilter(const std::vector<int>& frames) const {
+    if (empty() || frames.size() <= kMinCandidates) return frames;
+
+    // Heavily quantized frames rarely win on sharpness
+    float minQp = -1.0f;
+    for (int frame : frames) {
+        const float q = qpAt(frame);
+        if (q >= 0.0f && (minQp < 0.0f || q < minQp)) minQp = q;
+    }
+    std::vector<int> kept;
+    for (int frame : frames) {
+        const float q = qpAt(frame);
+        if (minQp < 0.0f || q < 0.0f || q <= minQp + kQpMargin) {
+            kept.push_back(frame);
+        }
+    }
+    if (kept.size() < kMinCandidates) {
+        kept = frames;
+    }
+
+    // Motion blur follows large motion vectors: keep the calmer half. Frames
+    // without motion data (intra frames) are always kept.
+    std::vector<int> unknown, known;
+    for (int frame : kept) {
+        (motionAt(frame) < 0.0f ? unknown : known).push_back(frame);
+    }
+    const size_t minKnown = unknown.size() < kMinCandidates ? kMinCandidates - unknown.size() : 0;
+    const size_t keep = std::max((known.size() + 1) / 2, minKnown);
+    if (known.size() > keep) {
+        std::stable_sort(known.begin(), known.end(),
+                         [this](int a, int b) { return motionAt(a) < motionAt(b); });
+        known.resize(keep);
+        kept = unknown;
+        kept.insert(kept.end(), known.begin(), known.end());
+        std::sort(kept.begin(), kept.end());
+    }
+    return kept;
+}
+
+#ifdef SHARPCTL_HAS_FFMPEG
+
+namespace {
+
+float meanMotion(const AVFrame* frame) {
+    const AVFrameSideData* sd = av_frame_get_side_data(frame, AV_FRAME_DATA_MOTION_VECTORS);
+    if (!sd || sd->size < sizeof(AVMotionVector)) return -1.0f;
+
+    const auto* mvs = reinterpret_cast<const AVMotionVector*>(sd->data);
+    const size_t count = sd->size / sizeof(AVMotionVector);
+
+    double sum = 0.0, area = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        const AVMotionVector& mv = mvs[i];
+        const double scale = mv.motion_scale > 0 ? mv.motion_scale : 1.0;
+        const double blockArea = static_cast<double>(mv.w) * mv.h;
+        sum += std::hypot(mv.motion_x / scale, mv.motion_y / scale) * blockArea;
+        area += blockArea;
+    }
+    return area > 0.0 ? static_cast<float>(sum / area) : -1.0f;
+}
+
+float meanQp(const AVFrame* frame) {
+    const AVFrameSideData* sd = av_frame_get_side_data(frame, AV_FRAME_DATA_VIDEO_ENC_PARAMS);
+    if (!sd) return -1.0f;
+
+    auto* params = reinterpret_cast<AVVideoEncParams*>(sd->data);
+    if (params->nb_blocks == 0) return static_cast<float>(params->qp);
+
+    double sum = 0.0, area = 0.0;
+    for (unsigned int i = 0; i < params->nb_blocks; ++i) {
+        const AVVideoBlockParams* block = av_video_enc_params_block(params, i);
+        const double blockArea = static_cast<double>(block->w) * block->h;
+        sum += (params->qp + block->delta_qp) * blockArea;
+        area += blockArea;
+    }
+    return area > 0.0 ? static_cast<float>(sum / area) : static_cast<float>(params->qp);
+}
+
+}  // anonymous namespace
+
+bool codecSideDataAvailable() {
+    return true;
+}
+
+bool probeCodecSideData(const std::string& videoPath, const FrameSource& source,
+                        CodecSideData& out,
+                        const std::function<bool(float progress)>& progress) {
+    out = CodecSideData{};
+
+    const int frameCount = source.getInfo().frameCount;
+    const double duration = source.getInfo().duration;
+    if (frameCount <= 0) return false;
+
+    AVFormatContext* format = nullptr;
+    if (avformat_open_input(&format, videoPath.c_str(), nullptr, nullptr) < 0) return false;
+
+    AVCodecContext* codec = nullptr;
+    AVPacket* packet = av_packet_alloc();
+    AVFrame* frame = av_frame_alloc();
+
+    auto cleanup = [&]() {
+        av_frame_free(&frame);
+        av_packet_free(&packet);
+        avcodec_free_context(&codec);
+        avformat_close_input(&format);
+    };
+
+    const AVCodec* decoder = nullptr;
+    int streamIndex = -1;
+    if (avformat_find_stream_info(format, nullptr) >= 0) {
+        streamIndex = av_find_best_stream(format, AVMEDIA_TYPE_VIDEO, -1, -1, &decoder, 0);
+    }
+    if (streamIndex < 0 || !decoder || !packet || !frame) {
+        cleanup();
+        return false;
+    }
+
+    const AVStream* stream = format->streams[streamIndex];
+    codec = avcodec_alloc_context3(decoder);
+    if (!codec || avcodec_parameters_to_context(codec, stream->codecpar) < 0) {
+        cleanup();
+        return false;
+    }
+    codec->export_side_data |= AV_CODEC_EXPORT_DATA_MVS | AV_CODEC_EXPORT_DATA_VIDEO_ENC_PARAMS;
+    codec->skip_loop_filter = AVDISCARD_ALL;  // Side data does not depend on deblocking
+    codec->skip_idct = AVDISCARD_ALL;         // nor on the residuals
+    codec->thread_count = 0;                  // Let the decoder pick
+    if (avcodec_open2(codec, decoder, nullptr) < 0) {
+        cleanup();
+        return false;
+    }
+
+    out.motion.assign(frameCount, -1.0f);
+    out.qp.assign(frameCount, -1.0f);
+
+    // Timestamps relative to the stream start, as the frame index stores them
+    const double timeBase = av_q2d(stream->time_base);
+    const int64_t startPts = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+    bool stopped = false;
+
+    auto receiveFrames = [&]() {
+        while (avcodec_receive_frame(codec, frame) == 0) {
+            const int64_t pts = frame->best_effort_timestamp;
+            if (pts != AV_NOPTS_VALUE) {
+                const double t = (pts - startPts) * timeBase;
+                const int index = source.frameAtTime(t);
+                out.motion[index] = meanMotion(frame);
+                out.qp[index] = meanQp(frame);
+
+                if (progress && duration > 0.0 &&
+                    !progress(static_cast<float>(std::clamp(t / duration, 0.0, 1.0)))) {
+                    stopped = true;
+                }
+            }
+            av_frame_unref(frame);
+        }
+    };
+
+    while (!stopped && av_read_frame(format, packet) >= 0) {
+        if (packet->stream_index == streamIndex && avcodec_send_packet(codec, packet) >= 0) {
+            receiveFrames();
+        }
+        av_packet_unref(packet);
+    }
+
+    // Drain frames still held for reordering
+    if (!stopped && avcodec_send_packet(codec, nullptr) >= 0) {
+        receiveFrames();
+    }
+
+    const bool ok = !stopped;
+    cleanup();
+    if (!ok) {
+        out = CodecSideData{};
+    }
+    return ok;
+}
+
+#else
+
+bool codecSideDataAvailable() {
+    return false;
+}
+
+bool probeCodecSideData(const std::string& /*videoPath*/, const FrameSource& /*source*/,
+                        CodecSideData& out,
+                        const std::function<bool(float progress)>& /*progress*/) {
+    out = CodecSideData{};
+    return false;
+}
+
+#endif  // SHARPCTL_HAS_FFMPEG
+
+}  // namespace sharpctl
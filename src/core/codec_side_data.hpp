@@ -0,0 +1,41 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace sharpctl {
+
+class FrameSource;
+
+// Per-frame statistics exported by the decoder alongside the pixels, indexed
+// like the FrameSource frames. Values are -1 where the decoder had nothing
+// to report (motion on intra frames, codecs without the side data).
+struct CodecSideData {
+    std::vector<float> motion;  // Mean motion vector length in pixels, weighted by block area
+    std::vector<float> qp;      // Mean quantizer, weighted by block area (codec-specific scale)
+
+    bool empty() const { return motion.empty(); }
+    float motionAt(int frame) const;
+    float qpAt(int frame) const;
+
+    // Cheap pre-selection of a search window's candidates before pixel
+    // scoring: drops frames quantized much harder than the window's best, then
+    // keeps the lower-motion half (never fewer than a few frames). Input and
+    // output are ascending frame indices.
+    std::vector<int> prefilter(const std::vector<int>& frames) const;
+};
+
+// Whether this build can read codec side data (compiled with FFmpeg)
+bool codecSideDataAvailable();
+
+// Decode the video once with motion vector and encoder parameter export
+// enabled. This is a pass of its own, since OpenCV's decoder does not hand
+// out side data; it skips the inverse transform and loop filter, as only
+// the side data is kept, which makes it cheaper than a full decode.
+// `progress` is called with 0..1 and stops the scan by returning false.
+bool probeCodecSideData(const std::string& videoPath, const FrameSource& source,
+                        CodecSideData& out,
+                        const std::function<bool(float progress)>& progress = nullptr);
+
+}  // namespace sharpctl
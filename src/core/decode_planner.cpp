@@ -0,0 +1,154 @@
+#include "decode_planner.hpp"
+#include "frame_source.hpp"
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+
+namespace sharpctl {
+
+namespace {
+
+constexpr int kMeasureFrames = 8;  // Sequential reads timed for the decode cost
+constexpr int kMeasureSeeks = 2;   // Keyframe seeks timed for the seek cost
+
+double elapsedMs(int64_t start) {
+    return (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+}
+
+// Cost of decoding frame `next` with the decoder positioned just after `prev`
+struct GapChoice {
+    bool seek;
+    long long decoded;
+};
+
+GapChoice chooseGap(int prev, int next, const FrameSource& source, const DecodeCosts& costs) {
+    const long long forward = next - prev;
+    const int keyframe = source.keyframeAtOrBefore(next);
+    if (keyframe <= prev + 1) {
+        return {false, forward};
+    }
+
+    const long long afterSeek = next - keyframe + 1;
+    const double forwardMs = forward * costs.decodeMs;
+    const double seekMs = costs.seekMs + afterSeek * costs.decodeMs;
+    return seekMs < forwardMs ? GapChoice{true, afterSeek} : GapChoice{false, forward};
+}
+
+}  // anonymous namespace
+
+size_t DecodePlan::slotOf(int frame) const {
+    return static_cast<size_t>(std::lower_bound(frames.begin(), frames.end(), frame) - frames.begin());
+}
+
+std::string DecodePlan::summary(int threads) const {
+    char text[256];
+    std::snprintf(text, sizeof(text),
+                  "Decode plan: %zu frames in %zu runs, %lld decoded, %d seeks, ~%.1fs on %d threads"
+                  " (seeking every frame: ~%.1fs)",
+                  frames.size(), runs.size(), decodedFrames, seeks,
+                  estimatedMs / 1000.0 / std::max(1, threads), threads,
+                  seekEachFrameMs / 1000.0 / std::max(1, threads));
+    return text;
+}
+
+DecodeCosts measureDecodeCosts(const FrameSource& source) {
+    DecodeCosts costs;
+
+    std::unique_ptr<FrameSource> probe = source.clone();
+    const int frameCount = source.getInfo().frameCount;
+    if (!probe || !probe->isOpen() || frameCount < 2) return costs;
+
+    // Sequential decode (the first read also pays for decoder start-up)
+    cv::Mat frame;
+    if (!probe->getLuma(0, frame)) return costs;
+    const int reads = std::min(kMeasureFrames, frameCount - 1);
+    int64_t start = cv::getTickCount();
+    int decoded = 0;
+    for (; decoded < reads && probe->readLuma(frame); ++decoded) {}
+    if (decoded > 0) {
+        costs.decodeMs = elapsedMs(start) / decoded;
+    }
+
+    // Seeks to keyframes spread over the input, minus the one frame read after each
+    double seekTotal = 0.0;
+    int seeks = 0;
+    for (int i = 1; i <= kMeasureSeeks; ++i) {
+        const int keyframe = source.keyframeAtOrBefore(frameCount * i / (kMeasureSeeks + 1));
+        start = cv::getTickCount();
+        if (!probe->getLuma(keyframe, frame)) break;
+        seekTotal += elapsedMs(start) - costs.decodeMs;
+        seeks++;
+    }
+    if (seeks > 0) {
+        costs.seekMs = std::max(0.0, seekTotal / seeks);
+    }
+    return costs;
+}
+
+DecodePlan planDecode(std::vector<int> frames, const FrameSource& source,
+                      const DecodeCosts& costs, size_t minRuns) {
+    DecodePlan plan;
+
+    std::sort(frames.begin(), frames.end());
+    frames.erase(std::unique(frames.begin(), frames.end()), frames.end());
+    frames.erase(frames.begin(), std::lower_bound(frames.begin(), frames.end(), 0));
+    plan.frames = std::move(frames);
+    if (plan.frames.empty()) return plan;
+
+    // Split points: needed frames reachable by a seek that decodes no more than continuing
+    std::vector<bool> splittable(plan.frames.size(), false);
+
+    // Workers start cold, so the first frame is always a seek
+    const int first = plan.frames.front();
+    plan.runs.push_back({0, 1});
+    plan.seeks = 1;
+    plan.decodedFrames = first - source.keyframeAtOrBefore(first) + 1;
+
+    for (size_t i = 1; i < plan.frames.size(); ++i) {
+        const int prev = plan.frames[i - 1];
+        const int next = plan.frames[i];
+        const GapChoice choice = chooseGap(prev, next, source, costs);
+
+        plan.decodedFrames += choice.decoded;
+        if (choice.seek) {
+            plan.runs.push_back({i, i + 1});
+            plan.seeks++;
+        } else {
+            plan.runs.back().end = i + 1;
+            splittable[i] = source.keyframeAtOrBefore(next) > prev;
+        }
+    }
+
+    // Split the longest runs at keyframes until every worker can get one
+    const size_t cap = (plan.frames.size() + minRuns - 1) / std::max<size_t>(minRuns, 1);
+    if (plan.runs.size() < minRuns && cap > 0) {
+        std::vector<DecodeRun> split;
+        for (const DecodeRun& run : plan.runs) {
+            DecodeRun current{run.begin, run.begin + 1};
+            for (size_t i = run.begin + 1; i < run.end; ++i) {
+                if (current.end - current.begin >= cap && splittable[i]) {
+                    split.push_back(current);
+                    current = {i, i};
+
+                    // The seek replaces decoding from the previous needed frame up to the keyframe
+                    const int keyframe = source.keyframeAtOrBefore(plan.frames[i]);
+                    plan.decodedFrames -= keyframe - plan.frames[i - 1] - 1;
+                    plan.seeks++;
+                }
+                current.end = i + 1;
+            }
+            split.push_back(current);
+        }
+        plan.runs = std::move(split);
+    }
+
+    plan.estimatedMs = plan.decodedFrames * costs.decodeMs + plan.seeks * costs.seekMs;
+    for (int frame : plan.frames) {
+        plan.seekEachFrameMs += costs.seekMs +
+                                (frame - source.keyframeAtOrBefore(frame) + 1) * costs.decodeMs;
+    }
+    return plan;
+}
+
+}  // namespace sharpctl
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace sharpctl {
+
+class FrameSource;
+
+// Measured cost of getting frames out of a source
+struct DecodeCosts {
+    double decodeMs = 5.0;  // Decoding (or reading) one frame
+    double seekMs = 20.0;   // Repositioning, excluding the frames decoded after it
+};
+
+// Frames [begin, end) of DecodePlan::frames, reached by one seek followed by
+// sequential decoding
+struct DecodeRun {
+    size_t begin = 0;
+    size_t end = 0;
+};
+
+struct DecodePlan {
+    std::vector<int> frames;      // Needed frames, ascending and unique
+    std::vector<DecodeRun> runs;  // Independent; may be decoded in parallel
+    long long decodedFrames = 0;  // Including frames decoded only to get past them
+    int seeks = 0;
+    double estimatedMs = 0.0;
+    double seekEachFrameMs = 0.0;  // Estimate for seeking to every needed frame
+
+    // Position of a needed frame in `frames`
+    size_t slotOf(int frame) const;
+
+    // One-line estimate, e.g. for the console before a pass starts
+    std::string summary(int threads) const;
+};
+
+// Time a few sequential reads and keyframe seeks on a clone of `source`
+DecodeCosts measureDecodeCosts(const FrameSource& source);
+
+// Order the needed frames into runs of sequential decoding joined by seeks,
+// minimizing estimated decode time. Between two consecutive needed frames the
+// decoder either continues forward or seeks to the keyframe at or before the
+// next one; the choice does not affect later gaps, so picking the cheaper
+// option per gap gives the minimal total. Runs are then split at keyframes
+// (costing one seek each) until there are at least `minRuns` of them, so
+// parallel workers have something to share.
+DecodePlan planDecode(std::vector<int> frames, const FrameSource& source,
+                      const DecodeCosts& costs, size_t minRuns = 1);
+
+}  // namespace sharpctl
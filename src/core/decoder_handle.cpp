@@ -0,0 +1,106 @@
+#include "decoder_handle.hpp"
+
+namespace sharpctl {
+
+const char* decoderUseName(DecoderUse use) {
+    switch (use) {
+        case DecoderUse::Preview: return "Preview";
+        case DecoderUse::Thumbnail: return "Thumbnails";
+        case DecoderUse::Manual: return "Manual";
+        case DecoderUse::Analysis: return "Analysis";
+        case DecoderUse::Refine: return "Refinement";
+        case DecoderUse::Export: return "Export";
+        default: return "?";
+    }
+}
+
+void DecoderStats::recordFrame(double ms) {
+    const uint64_t micros = static_cast<uint64_t>(ms * 1000.0);
+    frames_.fetch_add(1, std::memory_order_relaxed);
+    totalMicros_.fetch_add(micros, std::memory_order_relaxed);
+
+    uint64_t max = maxMicros_.load(std::memory_order_relaxed);
+    while (micros > max && !maxMicros_.compare_exchange_weak(max, micros, std::memory_order_relaxed)) {}
+}
+
+DecoderStats::Snapshot DecoderStats::get() const {
+    Snapshot snapshot;
+    snapshot.seeks = seeks_.load(std::memory_order_relaxed);
+    snapshot.frames = frames_.load(std::memory_order_relaxed);
+    snapshot.totalMs = totalMicros_.load(std::memory_order_relaxed) / 1000.0;
+    snapshot.maxMs = maxMicros_.load(std::memory_order_relaxed) / 1000.0;
+    return snapshot;
+}
+
+void DecoderStats::reset() {
+    seeks_.store(0, std::memory_order_relaxed);
+    frames_.store(0, std::memory_order_relaxed);
+    totalMicros_.store(0, std::memory_order_relaxed);
+    maxMicros_.store(0, std::memory_order_relaxed);
+}
+
+DecoderHandle::DecoderHandle(std::unique_ptr<FrameSource> source, std::shared_ptr<DecoderStats> stats,
+                             bool isProxy)
+    : source_(std::move(source)), stats_(std::move(stats)), isProxy_(isProxy) {}
+
+bool DecoderHandle::open(const std::string& path) {
+    pendingTicks_ = 0;
+    return source_->open(path);
+}
+
+void DecoderHandle::close() {
+    pendingTicks_ = 0;
+    source_->close();
+}
+
+std::unique_ptr<FrameSource> DecoderHandle::clone() const {
+    std::unique_ptr<FrameSource> source = source_->clone();
+    if (!source) return nullptr;
+    return std::make_unique<DecoderHandle>(std::move(source), stats_, isProxy_);
+}
+
+void DecoderHandle::addPending(int64_t start) {
+    pendingTicks_ += cv::getTickCount() - start;
+}
+
+void DecoderHandle::finishFrame(int64_t start, bool ok) {
+    addPending(start);
+    if (ok && stats_) {
+        stats_->recordFrame(pendingTicks_ * 1000.0 / cv::getTickFrequency());
+    }
+    pendingTicks_ = 0;
+}
+
+bool DecoderHandle::seekFrame(int index) {
+    const int64_t start = cv::getTickCount();
+    const int before = source_->getPosition();
+    const bool ok = source_->seekFrame(index);
+    addPending(start);
+    if (ok && stats_ && source_->getPosition() != before) {
+        stats_->recordSeek();
+    }
+    return ok;
+}
+
+bool DecoderHandle::skipFrame() {
+    const int64_t start = cv::getTickCount();
+    const bool ok = source_->skipFrame();
+    addPending(start);
+    return ok;
+}
+
+bool DecoderHandle::readFrame(cv::Mat& outFrame) {
+    const int64_t start = cv::getTickCount();
+    const bool ok = source_->readFrame(outFrame);
+    finishFrame(start, ok);
+    return ok;
+}
+
+bool DecoderHandle::readLuma(cv::Mat& outGray, int reduction) {
+    const int64_t start = cv::getTickCount();
+    const bool ok = source_->readLuma(outGray, reduction);
+    finishFrame(start, ok);
+    return ok;
+}
+
+}  // namespace sharpctl
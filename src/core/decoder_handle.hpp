@@ -0,0 +1,100 @@
+#pragma once
+
+#include "frame_source.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace sharpctl {
+
+// Consumers that decode independently of each other, each with its own
+// handles and statistics
+enum class DecoderUse {
+    Preview,    // Hover previews
+    Thumbnail,  // Filmstrip thumbnails
+    Manual,     // Frames added by hand
+    Analysis,   // Graph and selection passes
+    Refine,     // Denser curve samples where the timeline is zoomed in
+    Export,
+    Count
+};
+
+constexpr size_t kDecoderUseCount = static_cast<size_t>(DecoderUse::Count);
+
+const char* decoderUseName(DecoderUse use);
+
+// Seek count and decode latency of one consumer, shared by all its handles.
+// A frame's latency is the decoder time spent getting it: the seek or the
+// frames skipped to reach it plus the read itself. Thread-safe.
+class DecoderStats {
+public:
+    struct Snapshot {
+        uint64_t seeks = 0;
+        uint64_t frames = 0;
+        double totalMs = 0.0;
+        double maxMs = 0.0;
+
+        double meanMs() const { return frames > 0 ? totalMs / frames : 0.0; }
+    };
+
+    void recordSeek() { seeks_.fetch_add(1, std::memory_order_relaxed); }
+    void recordFrame(double ms);
+    Snapshot get() const;
+    void reset();
+
+private:
+    std::atomic<uint64_t> seeks_{0};
+    std::atomic<uint64_t> frames_{0};
+    std::atomic<uint64_t> totalMicros_{0};
+    std::atomic<uint64_t> maxMicros_{0};
+};
+
+using DecoderStatsArray = std::array<std::shared_ptr<DecoderStats>, kDecoderUseCount>;
+
+// A FrameSource owned by one consumer, counting its seeks and decode time.
+// Like any FrameSource it is used from one thread at a time; clones count
+// towards the same statistics. Seeks count only when they succeed and
+// move the position.
+class DecoderHandle : public FrameSource {
+public:
+    // `source` must not be null
+    DecoderHandle(std::unique_ptr<FrameSource> source, std::shared_ptr<DecoderStats> stats,
+                  bool isProxy = false);
+
+    // Decoding the scrub proxy rather than the input
+    bool isProxy() const { return isProxy_; }
+
+    bool open(const std::string& path) override;
+    void close() override;
+    bool isOpen() const override { return source_->isOpen(); }
+    const VideoInfo& getInfo() const override { return source_->getInfo(); }
+    // Null if the wrapped source cannot be cloned
+    std::unique_ptr<FrameSource> clone() const override;
+
+    bool seekFrame(int index) override;
+    int getPosition() const override { return source_->getPosition(); }
+    bool readFrame(cv::Mat& outFrame) override;
+    bool skipFrame() override;
+    bool readLuma(cv::Mat& outGray, int reduction = 1) override;
+
+    void prefetch(const std::vector<int>& indices) override { source_->prefetch(indices); }
+    void setAccessPattern(AccessPattern pattern) override { source_->setAccessPattern(pattern); }
+
+    int frameAtTime(double timeSec) const override { return source_->frameAtTime(timeSec); }
+    double timeOfFrame(int index) const override { return source_->timeOfFrame(index); }
+    int keyframeAtOrBefore(int index) const override { return source_->keyframeAtOrBefore(index); }
+    std::vector<int> keyframes() const override { return source_->keyframes(); }
+
+private:
+    // Charge decoder time since `start` to the next frame read
+    void addPending(int64_t start);
+    void finishFrame(int64_t start, bool ok);
+
+    std::unique_ptr<FrameSource> source_;
+    std::shared_ptr<DecoderStats> stats_;
+    bool isProxy_ = false;
+    int64_t pendingTicks_ = 0;
+};
+
+}  // namespace sharpctl
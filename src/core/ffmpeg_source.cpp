@@ -0,0 +1,368 @@
+#include "ffmpeg_source.hpp"
+#include <algorithm>
+#include <cmath>
+
+#ifdef SHARPCTL_HAS_FFMPEG
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+#include <libavutil/pixdesc.h>
+#include <libswscale/swscale.h>
+}
+#endif
+
+namespace sharpctl {
+
+namespace {
+
+// Re-seek attempts when the demuxer lands past the target
+constexpr int kMaxSeekRetries = 3;
+
+}  // anonymous namespace
+
+#ifdef SHARPCTL_HAS_FFMPEG
+
+namespace {
+
+// Luma precision of `format` when its Y plane can be wrapped as is (planar,
+// little-endian, one sample per byte or 16-bit word), else 0
+int directLumaDepth(AVPixelFormat format) {
+    const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(format);
+    if (!desc || (desc->flags & (AV_PIX_FMT_FLAG_BE | AV_PIX_FMT_FLAG_HWACCEL | AV_PIX_FMT_FLAG_PAL |
+                                 AV_PIX_FMT_FLAG_RGB))) {
+        return 0;
+    }
+    const AVComponentDescriptor& y = desc->comp[0];
+    if (y.plane != 0 || y.offset != 0) return 0;
+    if (y.step == 1 && y.depth == 8 && y.shift == 0) return 8;
+    if (y.step == 2 && y.depth > 8 && y.depth + y.shift <= 16) return y.depth;
+    return 0;
+}
+
+}  // anonymous namespace
+
+struct FfmpegSource::Decoder {
+    AVFormatContext* format = nullptr;
+    AVCodecContext* codec = nullptr;
+    AVPacket* packet = nullptr;
+    AVFrame* frame = nullptr;
+    SwsContext* toBgr = nullptr;
+    int streamIndex = -1;
+    double timeBase = 0.0;
+    int64_t startPts = 0;
+    AVPixelFormat pixelFormat = AV_PIX_FMT_NONE;
+    int lumaShift = 0;     // Bits below the samples in each word (P010-style formats)
+    bool flushed = false;  // End of stream sent to the decoder
+
+    ~Decoder() {
+        sws_freeContext(toBgr);
+        av_frame_free(&frame);
+        av_packet_free(&packet);
+        avcodec_free_context(&codec);
+        avformat_close_input(&format);
+    }
+
+    bool open(const std::string& path) {
+        if (avformat_open_input(&format, path.c_str(), nullptr, nullptr) < 0) return false;
+
+        const AVCodec* decoder = nullptr;
+        if (avformat_find_stream_info(format, nullptr) >= 0) {
+            streamIndex = av_find_best_stream(format, AVMEDIA_TYPE_VIDEO, -1, -1, &decoder, 0);
+        }
+        packet = av_packet_alloc();
+        frame = av_frame_alloc();
+        if (streamIndex < 0 || !decoder || !packet || !frame) return false;
+
+        const AVStream* stream = format->streams[streamIndex];
+        codec = avcodec_alloc_context3(decoder);
+        if (!codec || avcodec_parameters_to_context(codec, stream->codecpar) < 0) return false;
+        codec->thread_count = 0;  // Let the decoder pick
+        if (avcodec_open2(codec, decoder, nullptr) < 0) return false;
+
+        // Timestamps relative to the stream start, as the frame index stores them
+        timeBase = av_q2d(stream->time_base);
+        startPts = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+        pixelFormat = codec->pix_fmt;
+        const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(pixelFormat);
+        lumaShift = desc ? desc->comp[0].shift : 0;
+        return true;
+    }
+
+    // Decode the next frame into `frame`; false at the end of the stream
+    bool next() {
+        av_frame_unref(frame);
+        while (true) {
+            const int received = avcodec_receive_frame(codec, frame);
+            if (received == 0) return true;
+            if (received != AVERROR(EAGAIN) || flushed) return false;
+
+            int read;
+            while ((read = av_read_frame(format, packet)) >= 0 && packet->stream_index != streamIndex) {
+                av_packet_unref(packet);
+            }
+            if (read < 0) {
+                // Drain frames still held for reordering
+                flushed = true;
+                avcodec_send_packet(codec, nullptr);
+                continue;
+            }
+            const int sent = avcodec_send_packet(codec, packet);
+            av_packet_unref(packet);
+            if (sent < 0 && sent != AVERROR_INVALIDDATA) return false;
+        }
+    }
+
+    // Move the demuxer to the keyframe at or before `timeSec`
+    bool seek(double timeSec) {
+        const int64_t pts = startPts + std::llround(timeSec / timeBase);
+        if (av_seek_frame(format, streamIndex, pts, AVSEEK_FLAG_BACKWARD) < 0) return false;
+        avcodec_flush_buffers(codec);
+        flushed = false;
+        return true;
+    }
+
+    // Time of the decoded frame, negative if it has no timestamp
+    double frameTime() const {
+        const int64_t pts = frame->best_effort_timestamp;
+        return pts != AV_NOPTS_VALUE ? (pts - startPts) * timeBase : -1.0;
+    }
+};
+
+int FfmpegSource::probeBitDepth(const std::string& path) {
+    AVFormatContext* format = nullptr;
+    if (avformat_open_input(&format, path.c_str(), nullptr, nullptr) < 0) return 0;
+
+    int depth = 0;
+    if (avformat_find_stream_info(format, nullptr) >= 0) {
+        const int stream = av_find_best_stream(format, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+        if (stream >= 0) {
+            const auto pixelFormat = static_cast<AVPixelFormat>(format->streams[stream]->codecpar->format);
+            if (const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(pixelFormat)) {
+                depth = desc->comp[0].depth;
+            }
+        }
+    }
+    avformat_close_input(&format);
+    return depth;
+}
+
+bool FfmpegSource::openDecoder(const std::string& path) {
+    decoder_ = std::make_unique<Decoder>();
+    const int depth = decoder_->open(path) ? directLumaDepth(decoder_->pixelFormat) : 0;
+    if (depth == 0) {
+        decoder_.reset();
+        return false;
+    }
+
+    AVStream* stream = decoder_->format->streams[decoder_->streamIndex];
+    info_.path = path;
+    info_.fps = av_q2d(av_guess_frame_rate(decoder_->format, stream, nullptr));
+    info_.width = decoder_->codec->width;
+    info_.height = decoder_->codec->height;
+    info_.bitDepth = depth;
+    position_ = 0;
+    decoded_ = false;
+    return true;
+}
+
+bool FfmpegSource::readFrame(cv::Mat& outFrame) {
+    if (!decodeCurrent()) return false;
+    const AVFrame* frame = decoder_->frame;
+
+    // High bit depth keeps its precision as 16-bit BGR (full 16-bit range)
+    const bool deep = info_.bitDepth > 8;
+    decoder_->toBgr = sws_getCachedContext(decoder_->toBgr, frame->width, frame->height,
+                                           static_cast<AVPixelFormat>(frame->format), frame->width,
+                                           frame->height, deep ? AV_PIX_FMT_BGR48 : AV_PIX_FMT_BGR24,
+                                           SWS_BILINEAR, nullptr, nullptr, nullptr);
+    if (!decoder_->toBgr) return false;
+
+    // The stream's own matrix and range (BT.2020 for most HDR material)
+    const int colorspace =
+        frame->colorspace != AVCOL_SPC_UNSPECIFIED ? static_cast<int>(frame->colorspace) : SWS_CS_DEFAULT;
+    sws_setColorspaceDetails(decoder_->toBgr, sws_getCoefficients(colorspace),
+                             frame->color_range == AVCOL_RANGE_JPEG, sws_getCoefficients(SWS_CS_DEFAULT), 1,
+                             0, 1 << 16, 1 << 16);
+
+    outFrame.create(frame->height, frame->width, deep ? CV_16UC3 : CV_8UC3);
+    uint8_t* dst[] = {outFrame.data};
+    const int dstStride[] = {static_cast<int>(outFrame.step)};
+    sws_scale(decoder_->toBgr, frame->data, frame->linesize, 0, frame->height, dst, dstStride);
+
+    decoded_ = false;
+    position_++;
+    return true;
+}
+
+bool FfmpegSource::readLuma(cv::Mat& outGray, int reduction) {
+    if (!decodeCurrent()) return false;
+    const AVFrame* frame = decoder_->frame;
+    if (frame->format != decoder_->pixelFormat) return false;
+
+    // Straight from the Y plane; the frame buffer is reused by the next decode
+    cv::Mat luma(frame->height, frame->width, info_.bitDepth > 8 ? CV_16UC1 : CV_8UC1, frame->data[0],
+                 frame->linesize[0]);
+    cv::Mat gray;
+    if (decoder_->lumaShift > 0) {
+        luma.convertTo(gray, CV_16U, 1.0 / (1 << decoder_->lumaShift));
+    } else if (reduction > 1) {
+        gray = luma;
+    } else {
+        gray = luma.clone();
+    }
+    toLuma(gray, outGray, reduction);
+
+    decoded_ = false;
+    position_++;
+    return true;
+}
+
+#else
+
+struct FfmpegSource::Decoder {
+    bool next() { return false; }
+    bool seek(double /*timeSec*/) { return false; }
+    double frameTime() const { return -1.0; }
+};
+
+int FfmpegSource::probeBitDepth(const std::string& /*path*/) {
+    return 0;
+}
+
+bool FfmpegSource::openDecoder(const std::string& /*path*/) {
+    return false;
+}
+
+bool FfmpegSource::readFrame(cv::Mat& /*outFrame*/) {
+    return false;
+}
+
+bool FfmpegSource::readLuma(cv::Mat& /*outGray*/, int /*reduction*/) {
+    return false;
+}
+
+#endif  // SHARPCTL_HAS_FFMPEG
+
+FfmpegSource::FfmpegSource() = default;
+
+FfmpegSource::~FfmpegSource() {
+    close();
+}
+
+bool FfmpegSource::open(const std::string& path) {
+    close();
+
+    if (!openDecoder(path)) {
+        return false;
+    }
+
+    // Seeks and the time <-> frame mapping need the index
+    auto index = std::make_shared<FrameIndex>();
+    if (!index->loadOrBuild(path) || index->empty()) {
+        close();
+        return false;
+    }
+    info_.frameCount = index->frameCount();
+    info_.duration = index->duration();
+    index_ = std::move(index);
+    return true;
+}
+
+void FfmpegSource::close() {
+    decoder_.reset();
+    index_.reset();
+    info_ = VideoInfo{};
+    position_ = 0;
+    decoded_ = false;
+}
+
+bool FfmpegSource::isOpen() const {
+    return decoder_ && index_;
+}
+
+std::unique_ptr<FrameSource> FfmpegSource::clone() const {
+    auto copy = std::make_unique<FfmpegSource>();
+    if (!info_.path.empty() && copy->openDecoder(info_.path)) {
+        copy->index_ = index_;
+        copy->info_ = info_;
+    }
+    return copy;
+}
+
+int FfmpegSource::frameAtTime(double timeSec) const {
+    if (index_) return index_->frameAtTime(timeSec);
+    return FrameSource::frameAtTime(timeSec);
+}
+
+double FfmpegSource::timeOfFrame(int index) const {
+    if (index_) return index_->timeOfFrame(index);
+    return FrameSource::timeOfFrame(index);
+}
+
+int FfmpegSource::keyframeAtOrBefore(int index) const {
+    if (index_) return index_->keyframeAtOrBefore(index);
+    return index;
+}
+
+std::vector<int> FfmpegSource::keyframes() const {
+    if (index_) return index_->keyframes();
+    return {};
+}
+
+bool FfmpegSource::decodeCurrent() {
+    if (!decoded_) {
+        if (!decoder_ || !decoder_->next()) return false;
+        decoded_ = true;
+    }
+    return true;
+}
+
+bool FfmpegSource::skipFrame() {
+    if (!decodeCurrent()) return false;
+    decoded_ = false;
+    position_++;
+    return true;
+}
+
+bool FfmpegSource::seekToKeyframe(int keyframe, int target) {
+    for (int attempt = 0; attempt < kMaxSeekRetries; ++attempt) {
+        if (!decoder_->seek(index_->timeOfFrame(keyframe)) || !decoder_->next()) {
+            return false;
+        }
+
+        // The decoded timestamp tells where the demuxer actually landed
+        const double landed = decoder_->frameTime();
+        position_ = landed >= 0.0 ? index_->frameAtTime(landed) : keyframe;
+        decoded_ = true;
+        if (position_ <= target) {
+            return true;
+        }
+        if (keyframe == 0) break;
+        keyframe = index_->keyframeAtOrBefore(keyframe - 1);
+    }
+
+    // Last resort: decode from the start
+    if (!decoder_->seek(0.0)) return false;
+    position_ = 0;
+    decoded_ = false;
+    return true;
+}
+
+bool FfmpegSource::seekFrame(int index) {
+    if (!isOpen() || index < 0 || index >= info_.frameCount) return false;
+    if (index == position_) return true;
+
+    bool needsSeek = false;
+    index_->framesToDecode(position_, index, &needsSeek);
+    if (needsSeek && !seekToKeyframe(index_->keyframeAtOrBefore(index), index)) {
+        return false;
+    }
+
+    // Decode forward to the target
+    while (position_ < index) {
+        if (!skipFrame()) return false;
+    }
+    return true;
+}
+
+}  // namespace sharpctl
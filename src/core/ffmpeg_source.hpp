@@ -0,0 +1,55 @@
+#pragma once
+
+#include "frame_source.hpp"
+#include "frame_index.hpp"
+
+namespace sharpctl {
+
+// Video file input decoded through libav (FFmpeg), for streams with more
+// than 8 bits per sample that cv::VideoCapture would reduce to 8-bit BGR.
+// readLuma() returns the decoded Y plane as CV_16U holding bitDepth bits,
+// readFrame() 16-bit BGR. Frame mapping and seeks follow a FrameIndex, as
+// in VideoCaptureSource. Without FFmpeg in the build it never opens.
+class FfmpegSource : public FrameSource {
+public:
+    // Bits per luma sample of the file's video stream, 0 if unknown
+    static int probeBitDepth(const std::string& path);
+
+    FfmpegSource();
+    ~FfmpegSource() override;
+
+    bool open(const std::string& path) override;
+    void close() override;
+    bool isOpen() const override;
+
+    const VideoInfo& getInfo() const override { return info_; }
+
+    std::unique_ptr<FrameSource> clone() const override;
+
+    bool seekFrame(int index) override;
+    int getPosition() const override { return position_; }
+    bool readFrame(cv::Mat& outFrame) override;
+    bool skipFrame() override;
+    bool readLuma(cv::Mat& outGray, int reduction = 1) override;
+
+    int frameAtTime(double timeSec) const override;
+    double timeOfFrame(int index) const override;
+    int keyframeAtOrBefore(int index) const override;
+    std::vector<int> keyframes() const override;
+
+private:
+    struct Decoder;  // libav state
+
+    bool openDecoder(const std::string& path);
+    bool seekToKeyframe(int keyframe, int target);
+    // Decode the frame at position_ unless it already is
+    bool decodeCurrent();
+
+    std::unique_ptr<Decoder> decoder_;
+    std::shared_ptr<const FrameIndex> index_;  // Shared with clones
+    VideoInfo info_;
+    int position_ = 0;      // Index of the next frame read
+    bool decoded_ = false;  // Frame at position_ is decoded, awaiting a read
+};
+
+}  // namespace sharpctl
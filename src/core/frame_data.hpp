@@ -1,6 +1,8 @@
 #pragma once
 
 #include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cmath>
 #include <vector>
 #include <string>
 
@@ -11,9 +13,22 @@ enum class SharpnessAlgorithm {
     Laplacian    // Laplacian variance
 };
 
+enum class ExportFormat {
+    JPEG,   // 8-bit
+    PNG,    // 16-bit for high bit depth sources
+    TIFF    // 16-bit for high bit depth sources
+};
+
+enum class ScanMode {
+    Full,       // Sample at sampleStepSec, search every frame in the window
+    Keyframes   // Intra frames only (fast triage of long footage)
+};
+
 struct FrameData {
     double time = 0.0;
+    int frameIndex = -1;
     double sharpness = 0.0;
+    float motion = -1.0f;  // Mean codec motion vector length in pixels, -1 if unknown
     bool selected = false;
     cv::Mat thumbnail;
 };
@@ -25,6 +40,7 @@ struct VideoInfo {
     int frameCount = 0;
     int width = 0;
     int height = 0;
+    int bitDepth = 8;  // Luma precision delivered by the source (8..16)
 
     bool isValid() const { return fps > 0.0 && frameCount > 0; }
 };
@@ -33,8 +49,15 @@ struct AnalysisParams {
     float intervalSec = 3.0f;
     float searchWindowSec = 0.5f;
     float searchStepSec = 0.02f;
+    float snapWindowSec = 0.2f;  // Frames added by hand snap to the sharpest within this (+/-)
     float sampleStepSec = 0.1f;  // For full video analysis (graph data)
+    int decodeReduction = 1;     // Score on luma downscaled by 1, 2, 4 or 8
     SharpnessAlgorithm algorithm = SharpnessAlgorithm::FFT;
+    ScanMode scanMode = ScanMode::Full;
+    bool codecPrefilter = false;  // Skip high-motion / high-QP candidates using decoder side data
+    bool useProxy = false;        // Build a scrub proxy and run the graph pass on it
+    int cpuCapPercent = 100;      // Duty-cycle pass workers to about this share of CPU time
+    bool lowPriority = false;     // Run pass workers at low CPU and I/O priority
 };
 
 struct AnalysisResult {
@@ -44,9 +67,36 @@ struct AnalysisResult {
     std::string error;
 };
 
+// Index of the frame nearest to `timeSec`, if closer than `maxDistance`;
+// -1 otherwise. `frames` must be sorted by time (binary search).
+inline int findNearestByTime(const std::vector<FrameData>& frames, double timeSec, double maxDistance) {
+    auto it = std::lower_bound(frames.begin(), frames.end(), timeSec,
+                               [](const FrameData& frame, double t) { return frame.time < t; });
+    int nearest = -1;
+    double nearestDist = maxDistance;
+    if (it != frames.end() && it->time - timeSec < nearestDist) {
+        nearest = static_cast<int>(it - frames.begin());
+        nearestDist = it->time - timeSec;
+    }
+    if (it != frames.begin() && timeSec - std::prev(it)->time < nearestDist) {
+        nearest = static_cast<int>(std::prev(it) - frames.begin());
+    }
+    return nearest;
+}
+
 // Helper to get config file path for a video
 inline std::string getConfigPath(const std::string& videoPath) {
     return videoPath + ".sharpctl";
 }
 
+// Helper to get the cached frame index path for a video
+inline std::string getIndexPath(const std::string& videoPath) {
+    return videoPath + ".sharpctl-index";
+}
+
+// Helper to get the scrub proxy path for a video
+inline std::string getProxyPath(const std::string& videoPath) {
+    return videoPath + ".sharpctl-proxy.avi";
+}
+
 }  // namespace sharpctl
@@ -0,0 +1,296 @@
+#include "frame_index.hpp"
+#include "frame_data.hpp"
+#include <opencv2/opencv.hpp>
+#include <filesystem>
+#include <fstream>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#ifdef SHARPCTL_HAS_FFMPEG
+extern "C" {
+#include <libavformat/avformat.h>
+}
+#endif
+
+namespace fs = std::filesystem;
+
+namespace sharpctl {
+
+namespace {
+
+constexpr char kIndexMagic[4] = {'S', 'C', 'I', 'X'};
+constexpr uint32_t kIndexVersion = 1;
+
+// Identifies the video an index was built from
+struct SourceStamp {
+    uint64_t size = 0;
+    int64_t mtime = 0;
+
+    bool operator==(const SourceStamp& other) const {
+        return size == other.size && mtime == other.mtime;
+    }
+};
+
+bool stampOf(const std::string& path, SourceStamp& out) {
+    std::error_code ec;
+    out.size = fs::file_size(path, ec);
+    if (ec) return false;
+    auto time = fs::last_write_time(path, ec);
+    if (ec) return false;
+    out.mtime = static_cast<int64_t>(time.time_since_epoch().count());
+    return true;
+}
+
+template <typename T>
+void writePod(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool readPod(std::ifstream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+}  // anonymous namespace
+
+bool FrameIndex::loadOrBuild(const std::string& videoPath) {
+    const std::string indexPath = getIndexPath(videoPath);
+    if (load(indexPath, videoPath)) return true;
+
+    if (!build(videoPath)) return false;
+
+    // A read-only video directory just means no cache next time
+    save(indexPath, videoPath);
+    return true;
+}
+
+bool FrameIndex::build(const std::string& videoPath) {
+    pts_.clear();
+    keyframes_.clear();
+
+    if (!scanPackets(videoPath)) {
+        pts_.clear();
+        keyframes_.clear();
+        if (!scanDecoded(videoPath)) return false;
+    }
+    return true;
+}
+
+bool FrameIndex::scanPackets(const std::string& videoPath) {
+    if (scanPacketsFfmpeg(videoPath)) return true;
+    pts_.clear();
+    keyframes_.clear();
+    return scanPacketsRaw(videoPath);
+}
+
+bool FrameIndex::setFromPackets(std::vector<Packet>& packets) {
+    if (packets.empty()) return false;
+
+    // Packets arrive in decode order; presentation order is by timestamp
+    std::sort(packets.begin(), packets.end(),
+              [](const Packet& a, const Packet& b) { return a.pts < b.pts; });
+
+    // Missing timestamps show up as duplicates; the decode scan handles those streams
+    for (size_t i = 1; i < packets.size(); ++i) {
+        if (packets[i].pts <= packets[i - 1].pts) return false;
+    }
+
+    pts_.reserve(packets.size());
+    for (size_t i = 0; i < packets.size(); ++i) {
+        pts_.push_back(packets[i].pts);
+        if (packets[i].key) {
+            keyframes_.push_back(static_cast<int>(i));
+        }
+    }
+
+    // Timestamps may start late (edit lists); the first decodable frame is a keyframe
+    if (!keyframes_.empty() && keyframes_.front() != 0) {
+        keyframes_.insert(keyframes_.begin(), 0);
+    }
+    return true;
+}
+
+bool FrameIndex::scanPacketsFfmpeg(const std::string& videoPath) {
+#ifdef SHARPCTL_HAS_FFMPEG
+    AVFormatContext* format = nullptr;
+    if (avformat_open_input(&format, videoPath.c_str(), nullptr, nullptr) < 0) return false;
+
+    AVPacket* packet = av_packet_alloc();
+    int streamIndex = -1;
+    if (packet && avformat_find_stream_info(format, nullptr) >= 0) {
+        streamIndex = av_find_best_stream(format, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+    }
+
+    // Timestamps relative to the stream start, as the decoders report them
+    std::vector<Packet> packets;
+    if (streamIndex >= 0) {
+        const AVStream* stream = format->streams[streamIndex];
+        const double timeBase = av_q2d(stream->time_base);
+        const int64_t startPts = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+        while (av_read_frame(format, packet) >= 0) {
+            if (packet->stream_index == streamIndex) {
+                if (packet->pts == AV_NOPTS_VALUE) {
+                    packets.clear();
+                    av_packet_unref(packet);
+                    break;
+                }
+                packets.push_back({(packet->pts - startPts) * timeBase,
+                                   (packet->flags & AV_PKT_FLAG_KEY) != 0});
+            }
+            av_packet_unref(packet);
+        }
+    }
+
+    av_packet_free(&packet);
+    avformat_close_input(&format);
+    return setFromPackets(packets);
+#else
+    (void)videoPath;
+    return false;
+#endif
+}
+
+bool FrameIndex::scanPacketsRaw(const std::string& videoPath) {
+    // Raw mode returns demuxed packets without decoding them
+    cv::VideoCapture cap;
+    if (!cap.open(videoPath, cv::CAP_FFMPEG, {cv::CAP_PROP_FORMAT, -1})) return false;
+
+    // Many OpenCV builds report no per-packet position in raw mode; the
+    // timestamps then come out as duplicates and the scan is rejected
+    std::vector<Packet> packets;
+    while (cap.grab()) {
+        packets.push_back({cap.get(cv::CAP_PROP_POS_MSEC) / 1000.0,
+                           cap.get(cv::CAP_PROP_LRF_HAS_KEY_FRAME) > 0.0});
+    }
+    return setFromPackets(packets);
+}
+
+bool FrameIndex::scanDecoded(const std::string& videoPath) {
+    cv::VideoCapture cap(videoPath);
+    if (!cap.isOpened()) return false;
+
+    while (cap.grab()) {
+        pts_.push_back(cap.get(cv::CAP_PROP_POS_MSEC) / 1000.0);
+    }
+    std::sort(pts_.begin(), pts_.end());
+    return !pts_.empty();
+}
+
+bool FrameIndex::load(const std::string& indexPath, const std::string& videoPath) {
+    pts_.clear();
+    keyframes_.clear();
+
+    SourceStamp expected;
+    if (!stampOf(videoPath, expected)) return false;
+
+    std::ifstream in(indexPath, std::ios::binary);
+    if (!in.is_open()) return false;
+
+    char magic[4];
+    uint32_t version = 0;
+    SourceStamp stamp;
+    uint32_t frameCount = 0, keyframeCount = 0;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kIndexMagic, sizeof(magic)) != 0 ||
+        !readPod(in, version) || version != kIndexVersion ||
+        !readPod(in, stamp.size) || !readPod(in, stamp.mtime) || !(stamp == expected) ||
+        !readPod(in, frameCount) || !readPod(in, keyframeCount) ||
+        keyframeCount > frameCount) {
+        return false;
+    }
+
+    // The counts must account for exactly the rest of the file
+    std::error_code ec;
+    const uint64_t fileSize = fs::file_size(indexPath, ec);
+    const uint64_t payload = uint64_t(frameCount) * sizeof(double) + uint64_t(keyframeCount) * sizeof(int);
+    if (ec || static_cast<uint64_t>(in.tellg()) + payload != fileSize) return false;
+
+    pts_.resize(frameCount);
+    keyframes_.resize(keyframeCount);
+    if (!in.read(reinterpret_cast<char*>(pts_.data()), frameCount * sizeof(double)) ||
+        !in.read(reinterpret_cast<char*>(keyframes_.data()), keyframeCount * sizeof(int))) {
+        pts_.clear();
+        keyframes_.clear();
+        return false;
+    }
+
+    // Reject a corrupt index rather than seek with it
+    const bool ordered = std::is_sorted(pts_.begin(), pts_.end()) &&
+                         std::is_sorted(keyframes_.begin(), keyframes_.end()) &&
+                         (keyframes_.empty() || (keyframes_.front() >= 0 &&
+                                                 keyframes_.back() < static_cast<int>(frameCount)));
+    if (!ordered) {
+        pts_.clear();
+        keyframes_.clear();
+        return false;
+    }
+    return !pts_.empty();
+}
+
+bool FrameIndex::save(const std::string& indexPath, const std::string& videoPath) const {
+    SourceStamp stamp;
+    if (pts_.empty() || !stampOf(videoPath, stamp)) return false;
+
+    std::ofstream out(indexPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) return false;
+
+    out.write(kIndexMagic, sizeof(kIndexMagic));
+    writePod(out, kIndexVersion);
+    writePod(out, stamp.size);
+    writePod(out, stamp.mtime);
+    writePod(out, static_cast<uint32_t>(pts_.size()));
+    writePod(out, static_cast<uint32_t>(keyframes_.size()));
+    out.write(reinterpret_cast<const char*>(pts_.data()), pts_.size() * sizeof(double));
+    out.write(reinterpret_cast<const char*>(keyframes_.data()), keyframes_.size() * sizeof(int));
+    return static_cast<bool>(out);
+}
+
+double FrameIndex::duration() const {
+    if (pts_.empty()) return 0.0;
+    if (pts_.size() == 1) return pts_.front();
+
+    // The last frame is shown for about as long as the one before it
+    const size_t n = pts_.size();
+    return pts_[n - 1] + (pts_[n - 1] - pts_[n - 2]);
+}
+
+double FrameIndex::timeOfFrame(int index) const {
+    if (pts_.empty()) return 0.0;
+    index = std::clamp(index, 0, frameCount() - 1);
+    return pts_[index];
+}
+
+int FrameIndex::frameAtTime(double timeSec) const {
+    if (pts_.empty()) return 0;
+
+    auto it = std::lower_bound(pts_.begin(), pts_.end(), timeSec);
+    if (it == pts_.end()) return frameCount() - 1;
+    if (it != pts_.begin() && (timeSec - *(it - 1)) < (*it - timeSec)) {
+        --it;
+    }
+    return static_cast<int>(it - pts_.begin());
+}
+
+bool FrameIndex::isKeyframe(int index) const {
+    if (!hasKeyframes()) return true;
+    return std::binary_search(keyframes_.begin(), keyframes_.end(), index);
+}
+
+int FrameIndex::keyframeAtOrBefore(int index) const {
+    if (!hasKeyframes()) return index;
+
+    auto it = std::upper_bound(keyframes_.begin(), keyframes_.end(), index);
+    if (it == keyframes_.begin()) return 0;
+    return *(it - 1);
+}
+
+int FrameIndex::framesToDecode(int position, int target, bool* needsSeek) const {
+    const int keyframe = keyframeAtOrBefore(target);
+
+    // Decoding forward is free of a seek as long as no keyframe is skipped
+    const bool forward = target >= position && keyframe <= position;
+    if (needsSeek) *needsSeek = !forward;
+    return forward ? (target - position + 1) : (target - keyframe + 1);
+}
+
+}  // namespace sharpctl
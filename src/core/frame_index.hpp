@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace sharpctl {
+
+// Presentation timestamps and keyframes of a video, in presentation order.
+// Built once by scanning the container and cached beside the video, so
+// time <-> frame mapping is exact on variable-frame-rate footage and seeks
+// know how many frames they will have to decode.
+class FrameIndex {
+public:
+    // Load the cached index for a video, or scan the video and write the cache
+    bool loadOrBuild(const std::string& videoPath);
+
+    // Scan the video (packet scan when the backend supports it, decode scan otherwise)
+    bool build(const std::string& videoPath);
+
+    bool load(const std::string& indexPath, const std::string& videoPath);
+    bool save(const std::string& indexPath, const std::string& videoPath) const;
+
+    bool empty() const { return pts_.empty(); }
+    int frameCount() const { return static_cast<int>(pts_.size()); }
+    double duration() const;
+
+    double timeOfFrame(int index) const;
+    int frameAtTime(double timeSec) const;  // Frame with the nearest timestamp
+
+    // Keyframes are only known after a packet scan; without them every frame
+    // is treated as a seek point (the pre-index behaviour)
+    bool hasKeyframes() const { return !keyframes_.empty(); }
+    const std::vector<int>& keyframes() const { return keyframes_; }
+    bool isKeyframe(int index) const;
+    int keyframeAtOrBefore(int index) const;
+
+    // Frames to decode to reach `target` from a decoder positioned at `position`
+    // (the next frame it would return), either by decoding forward or by seeking
+    int framesToDecode(int position, int target, bool* needsSeek = nullptr) const;
+
+private:
+    struct Packet {
+        double pts;
+        bool key;
+    };
+
+    // Packet scan through FFmpeg when built with it, else OpenCV's raw mode
+    bool scanPackets(const std::string& videoPath);
+    bool scanPacketsFfmpeg(const std::string& videoPath);
+    bool scanPacketsRaw(const std::string& videoPath);
+    // Fill the index from packets in decode order; false without usable timestamps
+    bool setFromPackets(std::vector<Packet>& packets);
+    bool scanDecoded(const std::string& videoPath);
+
+    std::vector<double> pts_;     // Seconds, ascending
+    std::vector<int> keyframes_;  // Frame indices, ascending
+};
+
+}  // namespace sharpctl
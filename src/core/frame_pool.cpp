@@ -0,0 +1,157 @@
+#include "frame_pool.hpp"
+#include <cstdlib>
+#include <sys/mman.h>
+
+namespace sharpctl {
+
+namespace {
+
+constexpr size_t kAlignment = 64;
+constexpr size_t kHugePageBytes = size_t(2) << 20;
+
+size_t roundUp(size_t bytes, size_t multiple) {
+    return (bytes + multiple - 1) / multiple * multiple;
+}
+
+}  // anonymous namespace
+
+FramePool& FramePool::instance() {
+    // Never destroyed: Mats in static storage may be released after main()
+    static FramePool* pool = new FramePool();
+    return *pool;
+}
+
+void FramePool::install() {
+    cv::Mat::setDefaultAllocator(&instance());
+}
+
+FramePool::~FramePool() {
+    trim();
+}
+
+void* FramePool::allocateBuffer(size_t bytes) {
+    if (bytes >= kHugePageBytes) {
+        const size_t length = roundUp(bytes, kHugePageBytes);
+        void* buffer = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (buffer == MAP_FAILED) return nullptr;
+#ifdef MADV_HUGEPAGE
+        madvise(buffer, length, MADV_HUGEPAGE);
+#endif
+        return buffer;
+    }
+
+    void* buffer = nullptr;
+    if (posix_memalign(&buffer, kAlignment, roundUp(bytes, kAlignment)) != 0) return nullptr;
+    return buffer;
+}
+
+void FramePool::releaseBuffer(void* buffer, size_t bytes) {
+    if (bytes >= kHugePageBytes) {
+        munmap(buffer, roundUp(bytes, kHugePageBytes));
+    } else {
+        std::free(buffer);
+    }
+}
+
+cv::UMatData* FramePool::allocate(int dims, const int* sizes, int type, void* data0, size_t* step,
+                                  cv::AccessFlag, cv::UMatUsageFlags) const {
+    // Same layout rules as OpenCV's standard allocator
+    size_t total = CV_ELEM_SIZE(type);
+    for (int i = dims - 1; i >= 0; i--) {
+        if (step) {
+            if (data0 && step[i] != CV_AUTOSTEP) {
+                CV_Assert(total <= step[i]);
+                total = step[i];
+            } else {
+                step[i] = total;
+            }
+        }
+        total *= sizes[i];
+    }
+
+    uchar* data = static_cast<uchar*>(data0);
+    if (!data && total < kMinPooledBytes) {
+        data = static_cast<uchar*>(cv::fastMalloc(total));
+    } else if (!data) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = free_.find(total);
+            if (it != free_.end()) {
+                data = static_cast<uchar*>(it->second);
+                freeBytes_ -= total;
+                free_.erase(it);
+                reused_++;
+            } else {
+                allocated_++;
+            }
+        }
+        if (!data) {
+            data = static_cast<uchar*>(allocateBuffer(total));
+            if (!data) {
+                CV_Error(cv::Error::StsNoMem, "FramePool: out of memory");
+            }
+        }
+    }
+
+    cv::UMatData* u = new cv::UMatData(this);
+    u->data = u->origdata = data;
+    u->size = total;
+    if (data0) {
+        u->flags |= cv::UMatData::USER_ALLOCATED;
+    }
+    return u;
+}
+
+bool FramePool::allocate(cv::UMatData* u, cv::AccessFlag, cv::UMatUsageFlags) const {
+    return u != nullptr;
+}
+
+void FramePool::deallocate(cv::UMatData* u) const {
+    if (!u) return;
+    CV_Assert(u->urefcount == 0);
+    CV_Assert(u->refcount == 0);
+
+    if (!(u->flags & cv::UMatData::USER_ALLOCATED)) {
+        if (u->size < kMinPooledBytes) {
+            cv::fastFree(u->origdata);
+        } else {
+            bool keep = false;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (freeBytes_ + u->size <= kMaxFreeBytes) {
+                    free_.emplace(u->size, u->origdata);
+                    freeBytes_ += u->size;
+                    keep = true;
+                }
+            }
+            if (!keep) {
+                releaseBuffer(u->origdata, u->size);
+            }
+        }
+        u->origdata = nullptr;
+    }
+    delete u;
+}
+
+void FramePool::trim() {
+    std::multimap<size_t, void*> idle;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        idle.swap(free_);
+        freeBytes_ = 0;
+    }
+    for (const auto& [bytes, buffer] : idle) {
+        releaseBuffer(buffer, bytes);
+    }
+}
+
+FramePool::Stats FramePool::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats;
+    stats.reused = reused_;
+    stats.allocated = allocated_;
+    stats.freeBytes = freeBytes_;
+    return stats;
+}
+
+}  // namespace sharpctl
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace sharpctl {
+
+// cv::Mat allocator that recycles frame-sized buffers. Decoders, color
+// conversions and resizes allocate the same few sizes for every frame; a
+// released buffer is kept and handed to the next allocation of exactly that
+// size instead of going back to the heap. Buffers are 64-byte aligned, and
+// those of a huge page or more are mmap'ed with MADV_HUGEPAGE to cut TLB
+// misses on 4K frames. Small allocations bypass the pool.
+class FramePool : public cv::MatAllocator {
+public:
+    static constexpr size_t kMinPooledBytes = size_t(256) << 10;  // Smaller Mats use the heap
+    static constexpr size_t kMaxFreeBytes = size_t(256) << 20;    // Idle buffers kept at most
+
+    struct Stats {
+        size_t reused = 0;      // Allocations served from the pool
+        size_t allocated = 0;   // Allocations that needed a new buffer
+        size_t freeBytes = 0;   // Idle buffers currently held
+    };
+
+    // Process-wide pool
+    static FramePool& instance();
+
+    // Make the pool the default allocator for every cv::Mat
+    static void install();
+
+    cv::UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step,
+                           cv::AccessFlag flags, cv::UMatUsageFlags usageFlags) const override;
+    bool allocate(cv::UMatData* data, cv::AccessFlag accessFlags,
+                  cv::UMatUsageFlags usageFlags) const override;
+    void deallocate(cv::UMatData* data) const override;
+
+    // Release all idle buffers
+    void trim();
+
+    Stats getStats() const;
+
+private:
+    FramePool() = default;
+    ~FramePool() override;
+
+    static void* allocateBuffer(size_t bytes);
+    static void releaseBuffer(void* buffer, size_t bytes);
+
+    mutable std::multimap<size_t, void*> free_;  // Idle buffers by size
+    mutable size_t freeBytes_ = 0;
+    mutable size_t reused_ = 0;
+    mutable size_t allocated_ = 0;
+    mutable std::mutex mutex_;
+};
+
+}  // namespace sharpctl
@@ -0,0 +1,90 @@
+#include "frame_source.hpp"
+#include "video_capture_source.hpp"
+#include "ffmpeg_source.hpp"
+#include "image_sequence_source.hpp"
+#include "y4m_source.hpp"
+#include <filesystem>
+#include <algorithm>
+#include <cmath>
+
+namespace fs = std::filesystem;
+
+namespace sharpctl {
+
+bool FrameSource::readLuma(cv::Mat& outGray, int reduction) {
+    cv::Mat frame;
+    if (!readFrame(frame)) return false;
+    toLuma(frame, outGray, reduction);
+    return true;
+}
+
+int FrameSource::frameAtTime(double timeSec) const {
+    const VideoInfo& info = getInfo();
+    if (info.fps <= 0.0 || info.frameCount <= 0) return 0;
+
+    int index = static_cast<int>(std::lround(timeSec * info.fps));
+    return std::clamp(index, 0, info.frameCount - 1);
+}
+
+double FrameSource::timeOfFrame(int index) const {
+    const VideoInfo& info = getInfo();
+    if (info.fps <= 0.0) return 0.0;
+    return index / info.fps;
+}
+
+bool FrameSource::getFrame(int index, cv::Mat& outFrame) {
+    if (getPosition() != index && !seekFrame(index)) return false;
+    return readFrame(outFrame);
+}
+
+bool FrameSource::getLuma(int index, cv::Mat& outGray, int reduction) {
+    if (getPosition() != index && !seekFrame(index)) return false;
+    return readLuma(outGray, reduction);
+}
+
+bool FrameSource::getFrameAt(double timeSec, cv::Mat& outFrame) {
+    return getFrame(frameAtTime(timeSec), outFrame);
+}
+
+std::unique_ptr<FrameSource> openFrameSource(const std::string& path) {
+    std::unique_ptr<FrameSource> source;
+
+    std::error_code ec;
+    if (fs::is_directory(path, ec)) {
+        source = std::make_unique<ImageSequenceSource>();
+    } else if (Y4mSource::isRawVideoFile(path)) {
+        source = std::make_unique<Y4mSource>();
+    } else if (FfmpegSource::probeBitDepth(path) > 8) {
+        // cv::VideoCapture would decode to 8-bit BGR
+        source = std::make_unique<FfmpegSource>();
+        if (source->open(path)) return source;
+        source = std::make_unique<VideoCaptureSource>();
+    } else {
+        source = std::make_unique<VideoCaptureSource>();
+    }
+
+    if (!source->open(path)) {
+        return nullptr;
+    }
+    return source;
+}
+
+void toLuma(const cv::Mat& frame, cv::Mat& outGray, int reduction) {
+    cv::Mat gray;
+    if (frame.channels() == 3) {
+        cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
+    } else if (frame.channels() == 4) {
+        cv::cvtColor(frame, gray, cv::COLOR_BGRA2GRAY);
+    } else {
+        gray = frame;
+    }
+
+    if (reduction > 1) {
+        cv::resize(gray, outGray, cv::Size(gray.cols / reduction, gray.rows / reduction),
+                   0, 0, cv::INTER_AREA);
+    } else {
+        outGray = gray;
+    }
+}
+
+}  // namespace sharpctl
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "frame_data.hpp"
+#include <opencv2/opencv.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sharpctl {
+
+// Expected read pattern, so backends can tune read-ahead
+enum class AccessPattern {
+    Normal,
+    Sequential,
+    Random
+};
+
+// Abstract input of decodable frames (video file, image directory, ...).
+// A FrameSource is not thread-safe; use clone() to get an independent
+// handle for each worker thread.
+class FrameSource {
+public:
+    virtual ~FrameSource() = default;
+
+    virtual bool open(const std::string& path) = 0;
+    virtual void close() = 0;
+    virtual bool isOpen() const = 0;
+
+    virtual const VideoInfo& getInfo() const = 0;
+
+    // Open an independent handle on the same input
+    virtual std::unique_ptr<FrameSource> clone() const = 0;
+
+    // Sequential iteration: position the source, then read frames in order
+    virtual bool seekFrame(int index) = 0;
+    virtual int getPosition() const = 0;
+    virtual bool readFrame(cv::Mat& outFrame) = 0;
+
+    // Move past the next frame without returning it. Decoders advance by
+    // decoding (no seek); the default repositions, which suits sources with
+    // independently readable frames.
+    virtual bool skipFrame() { return seekFrame(getPosition() + 1); }
+
+    // Read the next frame as luma, downscaled by `reduction` (1, 2, 4 or 8).
+    // The result is CV_8U, or CV_16U holding getInfo().bitDepth bits for high
+    // bit depth sources. Backends that can decode straight to reduced grayscale
+    // override this.
+    virtual bool readLuma(cv::Mat& outGray, int reduction = 1);
+
+    // Hint the indices that are about to be read so the backend can prefetch
+    virtual void prefetch(const std::vector<int>& /*indices*/) {}
+
+    // Hint how the following reads will move through the input
+    virtual void setAccessPattern(AccessPattern /*pattern*/) {}
+
+    // Time <-> frame mapping
+    virtual int frameAtTime(double timeSec) const;
+    virtual double timeOfFrame(int index) const;
+
+    // Nearest frame at or before `index` that can be decoded without its
+    // predecessors. Sources with independent frames return `index`.
+    virtual int keyframeAtOrBefore(int index) const { return index; }
+
+    // All keyframe indices, ascending. Empty when every frame is independent
+    // or keyframes are unknown.
+    virtual std::vector<int> keyframes() const { return {}; }
+
+    // Random access helpers
+    bool getFrame(int index, cv::Mat& outFrame);
+    bool getLuma(int index, cv::Mat& outGray, int reduction = 1);
+    bool getFrameAt(double timeSec, cv::Mat& outFrame);
+};
+
+// Open the matching backend for a path: directories are read as image
+// sequences, .y4m/.yuv files are memory-mapped, video with more than 8 bits
+// per sample is decoded through FFmpeg when available, everything else goes
+// through cv::VideoCapture. Returns nullptr on failure.
+std::unique_ptr<FrameSource> openFrameSource(const std::string& path);
+
+// Convert a decoded frame to luma (keeping its depth), downscaled by `reduction`
+void toLuma(const cv::Mat& frame, cv::Mat& outGray, int reduction = 1);
+
+}  // namespace sharpctl
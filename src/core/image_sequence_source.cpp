@@ -0,0 +1,272 @@
+#include "image_sequence_source.hpp"
+#include <filesystem>
+#include <fstream>
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <cctype>
+
+namespace fs = std::filesystem;
+
+namespace sharpctl {
+
+namespace {
+
+// Bounds for the read-ahead buffer
+constexpr size_t kPrefetchDepth = 64;
+constexpr size_t kPrefetchBytes = 256u * 1024 * 1024;
+
+// Natural order: "img_2.jpg" < "img_10.jpg"
+bool naturalLess(const std::string& a, const std::string& b) {
+    size_t i = 0, j = 0;
+    while (i < a.size() && j < b.size()) {
+        if (std::isdigit(static_cast<unsigned char>(a[i])) &&
+            std::isdigit(static_cast<unsigned char>(b[j]))) {
+            size_t ei = i, ej = j;
+            while (ei < a.size() && std::isdigit(static_cast<unsigned char>(a[ei]))) ei++;
+            while (ej < b.size() && std::isdigit(static_cast<unsigned char>(b[ej]))) ej++;
+
+            // Compare numeric runs by value (length after stripping leading zeros, then digits)
+            size_t si = i, sj = j;
+            while (si + 1 < ei && a[si] == '0') si++;
+            while (sj + 1 < ej && b[sj] == '0') sj++;
+            if (ei - si != ej - sj) return (ei - si) < (ej - sj);
+            int cmp = a.compare(si, ei - si, b, sj, ej - sj);
+            if (cmp != 0) return cmp < 0;
+
+            i = ei;
+            j = ej;
+        } else {
+            if (a[i] != b[j]) return a[i] < b[j];
+            i++;
+            j++;
+        }
+    }
+    return a.size() - i < b.size() - j;
+}
+
+bool readFileBytes(const std::string& path, std::vector<uchar>& out) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return false;
+
+    const std::streamsize size = file.tellg();
+    if (size <= 0) return false;
+
+    out.resize(static_cast<size_t>(size));
+    file.seekg(0);
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(out.data()), size));
+}
+
+int reducedGrayscaleFlag(int reduction) {
+    switch (reduction) {
+        case 2: return cv::IMREAD_REDUCED_GRAYSCALE_2;
+        case 4: return cv::IMREAD_REDUCED_GRAYSCALE_4;
+        case 8: return cv::IMREAD_REDUCED_GRAYSCALE_8;
+        default: return cv::IMREAD_GRAYSCALE;
+    }
+}
+
+int depthFlag(int bitDepth) {
+    return bitDepth > 8 ? cv::IMREAD_ANYDEPTH : 0;
+}
+
+}  // anonymous namespace
+
+// File list and read-ahead state shared by all clones of a source
+struct ImageSequenceSource::Shared {
+    std::vector<std::string> files;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::vector<int> plan;                 // Indices in expected read order
+    size_t planPos = 0;                    // Next plan entry to fetch
+    std::unordered_map<int, std::vector<uchar>> ready;
+    std::unordered_set<int> consumed;      // Read by a worker before the prefetcher got to it
+    size_t readyBytes = 0;
+    uint64_t generation = 0;               // Bumped whenever the plan is replaced
+    bool stop = false;
+    std::thread thread;
+
+    ~Shared() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        wake.notify_all();
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+
+    void schedule(const std::vector<int>& indices) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            plan = indices;
+            planPos = 0;
+            generation++;
+            ready.clear();
+            consumed.clear();
+            readyBytes = 0;
+            if (!plan.empty() && !thread.joinable()) {
+                thread = std::thread([this]() { run(); });
+            }
+        }
+        wake.notify_all();
+    }
+
+    // Take a prefetched file, or mark the index so the prefetcher skips it
+    bool take(int index, std::vector<uchar>& out) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = ready.find(index);
+            if (it == ready.end()) {
+                if (planPos < plan.size()) {
+                    consumed.insert(index);
+                }
+                return false;
+            }
+            out = std::move(it->second);
+            readyBytes -= out.size();
+            ready.erase(it);
+        }
+        wake.notify_all();
+        return true;
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stop) {
+            wake.wait(lock, [this]() {
+                return stop || (planPos < plan.size() &&
+                                ready.size() < kPrefetchDepth &&
+                                readyBytes < kPrefetchBytes);
+            });
+            if (stop) break;
+
+            const int index = plan[planPos++];
+            if (consumed.erase(index) > 0 || ready.count(index) > 0 ||
+                index < 0 || index >= static_cast<int>(files.size())) {
+                continue;
+            }
+
+            // Read without holding the lock
+            const std::string path = files[index];
+            const uint64_t fetchGeneration = generation;
+            lock.unlock();
+            std::vector<uchar> bytes;
+            bool ok = readFileBytes(path, bytes);
+            lock.lock();
+
+            // Drop the result if the plan was replaced or a worker already read the file
+            if (!ok || stop || generation != fetchGeneration || consumed.erase(index) > 0) {
+                continue;
+            }
+            readyBytes += bytes.size();
+            ready.emplace(index, std::move(bytes));
+        }
+    }
+};
+
+ImageSequenceSource::~ImageSequenceSource() {
+    close();
+}
+
+bool ImageSequenceSource::isImageFile(const std::string& path) {
+    std::string ext = fs::path(path).extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return ext == ".jpg" || ext == ".jpeg" || ext == ".png" || ext == ".tif" ||
+           ext == ".tiff" || ext == ".bmp" || ext == ".webp";
+}
+
+bool ImageSequenceSource::open(const std::string& path) {
+    close();
+
+    std::error_code ec;
+    if (!fs::is_directory(path, ec)) return false;
+
+    auto shared = std::make_shared<Shared>();
+    for (const auto& entry : fs::directory_iterator(path, ec)) {
+        if (entry.is_regular_file() && isImageFile(entry.path().string())) {
+            shared->files.push_back(entry.path().string());
+        }
+    }
+    if (shared->files.empty()) return false;
+
+    std::sort(shared->files.begin(), shared->files.end(),
+              [](const std::string& a, const std::string& b) {
+                  return naturalLess(fs::path(a).filename().string(),
+                                     fs::path(b).filename().string());
+              });
+
+    // Frame size and precision come from the first image (16-bit PNG/TIFF stay 16-bit)
+    cv::Mat first = cv::imread(shared->files.front(), cv::IMREAD_UNCHANGED);
+    if (first.empty()) return false;
+
+    info_.path = path;
+    info_.fps = kDefaultFps;
+    info_.frameCount = static_cast<int>(shared->files.size());
+    info_.width = first.cols;
+    info_.height = first.rows;
+    info_.bitDepth = first.depth() == CV_16U ? 16 : 8;
+    info_.duration = info_.frameCount / info_.fps;
+
+    shared_ = std::move(shared);
+    position_ = 0;
+    return true;
+}
+
+void ImageSequenceSource::close() {
+    shared_.reset();
+    info_ = VideoInfo{};
+    position_ = 0;
+}
+
+std::unique_ptr<FrameSource> ImageSequenceSource::clone() const {
+    auto copy = std::make_unique<ImageSequenceSource>();
+    copy->shared_ = shared_;
+    copy->info_ = info_;
+    return copy;
+}
+
+bool ImageSequenceSource::seekFrame(int index) {
+    if (!shared_ || index < 0 || index >= info_.frameCount) return false;
+    position_ = index;
+    return true;
+}
+
+bool ImageSequenceSource::readEncoded(std::vector<uchar>& outBytes) {
+    if (!shared_ || position_ < 0 || position_ >= info_.frameCount) return false;
+
+    const int index = position_++;
+    if (shared_->take(index, outBytes)) return true;
+    return readFileBytes(shared_->files[index], outBytes);
+}
+
+bool ImageSequenceSource::readFrame(cv::Mat& outFrame) {
+    std::vector<uchar> bytes;
+    if (!readEncoded(bytes)) return false;
+
+    outFrame = cv::imdecode(bytes, cv::IMREAD_COLOR | depthFlag(info_.bitDepth));
+    return !outFrame.empty();
+}
+
+bool ImageSequenceSource::readLuma(cv::Mat& outGray, int reduction) {
+    std::vector<uchar> bytes;
+    if (!readEncoded(bytes)) return false;
+
+    // Decoders like libjpeg scale during decode, which is much cheaper than a full decode + resize
+    outGray = cv::imdecode(bytes, reducedGrayscaleFlag(reduction) | depthFlag(info_.bitDepth));
+    return !outGray.empty();
+}
+
+void ImageSequenceSource::prefetch(const std::vector<int>& indices) {
+    if (shared_) {
+        shared_->schedule(indices);
+    }
+}
+
+}  // namespace sharpctl
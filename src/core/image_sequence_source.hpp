@@ -0,0 +1,46 @@
+#pragma once
+
+#include "frame_source.hpp"
+
+namespace sharpctl {
+
+// Directory of still images (camera bursts) read as a frame sequence.
+// Files are ordered by natural filename order and mapped to a nominal frame rate.
+// Clones share one prefetcher that reads upcoming files into memory ahead of
+// the workers, which then decode in parallel.
+class ImageSequenceSource : public FrameSource {
+public:
+    static constexpr double kDefaultFps = 30.0;
+
+    ImageSequenceSource() = default;
+    ~ImageSequenceSource() override;
+
+    bool open(const std::string& path) override;
+    void close() override;
+    bool isOpen() const override { return shared_ != nullptr; }
+
+    const VideoInfo& getInfo() const override { return info_; }
+
+    std::unique_ptr<FrameSource> clone() const override;
+
+    bool seekFrame(int index) override;
+    int getPosition() const override { return position_; }
+    bool readFrame(cv::Mat& outFrame) override;
+    bool readLuma(cv::Mat& outGray, int reduction = 1) override;
+
+    void prefetch(const std::vector<int>& indices) override;
+
+    // Check whether a path is a supported still image
+    static bool isImageFile(const std::string& path);
+
+private:
+    struct Shared;
+
+    bool readEncoded(std::vector<uchar>& outBytes);
+
+    std::shared_ptr<Shared> shared_;
+    VideoInfo info_;
+    int position_ = 0;
+};
+
+}  // namespace sharpctl
@@ -0,0 +1,54 @@
+#include "interactive_gate.hpp"
+
+namespace sharpctl {
+
+InteractiveGate::Ticket::Ticket(InteractiveGate& gate) : gate_(&gate) {
+    gate.active_.fetch_add(1, std::memory_order_acq_rel);
+}
+
+InteractiveGate::Ticket& InteractiveGate::Ticket::operator=(Ticket&& other) noexcept {
+    if (this != &other) {
+        release();
+        gate_ = other.gate_;
+        other.gate_ = nullptr;
+    }
+    return *this;
+}
+
+void InteractiveGate::Ticket::release() {
+    if (gate_) {
+        gate_->leave();
+        gate_ = nullptr;
+    }
+}
+
+void InteractiveGate::leave() {
+    if (active_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        // Taking the lock orders this with a waiter's predicate check
+        std::lock_guard<std::mutex> lock(mutex_);
+        idle_.notify_all();
+    }
+}
+
+void InteractiveGate::yield() {
+    if (!isBusy()) return;
+
+    const auto start = std::chrono::steady_clock::now();
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_.wait_until(lock, start + kMaxYield, [this]() { return !isBusy(); });
+    }
+    const auto waited = std::chrono::steady_clock::now() - start;
+    yields_.fetch_add(1, std::memory_order_relaxed);
+    yieldedMicros_.fetch_add(std::chrono::duration_cast<std::chrono::microseconds>(waited).count(),
+                             std::memory_order_relaxed);
+}
+
+InteractiveGate::Stats InteractiveGate::getStats() const {
+    Stats stats;
+    stats.yields = yields_.load(std::memory_order_relaxed);
+    stats.yieldedMs = yieldedMicros_.load(std::memory_order_relaxed) / 1000.0;
+    return stats;
+}
+
+}  // namespace sharpctl
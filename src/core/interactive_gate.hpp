@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace sharpctl {
+
+// Priority between interactive decoding (hover previews, manual adds) and
+// background work (analysis passes, thumbnails, proxy building). Interactive
+// work holds a Ticket while it runs; background workers call yield() between
+// frames and wait while any ticket is out, so the interactive request gets
+// the CPU and disk to itself. A single yield never lasts longer than
+// kMaxYield, so constant scrubbing slows background work down but cannot
+// stall it. Thread-safe.
+class InteractiveGate {
+public:
+    static constexpr std::chrono::milliseconds kMaxYield{200};
+
+    struct Stats {
+        uint64_t yields = 0;      // Yields that actually waited
+        double yieldedMs = 0.0;   // Summed over all background threads
+    };
+
+    // Marks interactive work in flight until destroyed or released
+    class Ticket {
+    public:
+        Ticket() = default;
+        explicit Ticket(InteractiveGate& gate);
+        ~Ticket() { release(); }
+
+        Ticket(Ticket&& other) noexcept : gate_(other.gate_) { other.gate_ = nullptr; }
+        Ticket& operator=(Ticket&& other) noexcept;
+        Ticket(const Ticket&) = delete;
+        Ticket& operator=(const Ticket&) = delete;
+
+        void release();
+
+    private:
+        InteractiveGate* gate_ = nullptr;
+    };
+
+    InteractiveGate() = default;
+    InteractiveGate(const InteractiveGate&) = delete;
+    InteractiveGate& operator=(const InteractiveGate&) = delete;
+
+    Ticket enter() { return Ticket(*this); }
+
+    // Background workers: wait while interactive work is in flight, at most
+    // kMaxYield. Free when there is none.
+    void yield();
+
+    bool isBusy() const { return active_.load(std::memory_order_acquire) > 0; }
+    Stats getStats() const;
+
+private:
+    void leave();
+
+    std::atomic<int> active_{0};
+    std::atomic<uint64_t> yields_{0};
+    std::atomic<uint64_t> yieldedMicros_{0};
+    std::mutex mutex_;
+    std::condition_variable idle_;
+};
+
+}  // namespace sharpctl
@@ -0,0 +1,133 @@
+#include "luma_cache.hpp"
+#include <cstring>
+
+#ifdef SHARPCTL_HAS_LZ4
+#include <lz4.h>
+#endif
+
+namespace sharpctl {
+
+bool LumaCache::isCompressed() {
+#ifdef SHARPCTL_HAS_LZ4
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool LumaCache::get(const Key& key, cv::Mat& outGray) {
+    Entry entry;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (it == entries_.end()) {
+            misses_++;
+            return false;
+        }
+        lru_.splice(lru_.begin(), lru_, it->second);
+        entry = *it->second;
+        hits_++;
+    }
+
+    outGray.create(entry.rows, entry.cols, entry.type);
+    const size_t rawBytes = outGray.total() * outGray.elemSize();
+    if (!entry.compressed) {
+        std::memcpy(outGray.data, entry.data->data(), rawBytes);
+        return true;
+    }
+
+#ifdef SHARPCTL_HAS_LZ4
+    const int decoded = LZ4_decompress_safe(entry.data->data(), reinterpret_cast<char*>(outGray.data),
+                                            static_cast<int>(entry.data->size()), static_cast<int>(rawBytes));
+    return decoded == static_cast<int>(rawBytes);
+#else
+    return false;
+#endif
+}
+
+bool LumaCache::contains(const Key& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (entries_.count(key) > 0) return true;
+    misses_++;
+    return false;
+}
+
+void LumaCache::put(const Key& key, const cv::Mat& gray) {
+    if (gray.empty()) return;
+
+    const cv::Mat src = gray.isContinuous() ? gray : gray.clone();
+    const size_t rawBytes = src.total() * src.elemSize();
+    if (rawBytes > budget_) return;
+
+    Entry entry;
+    entry.key = key;
+    entry.rows = src.rows;
+    entry.cols = src.cols;
+    entry.type = src.type();
+
+    auto data = std::make_shared<std::vector<char>>();
+#ifdef SHARPCTL_HAS_LZ4
+    data->resize(LZ4_compressBound(static_cast<int>(rawBytes)));
+    const int packed = LZ4_compress_default(reinterpret_cast<const char*>(src.data), data->data(),
+                                            static_cast<int>(rawBytes), static_cast<int>(data->size()));
+    // Keep incompressible frames (noise) raw
+    if (packed > 0 && static_cast<size_t>(packed) < rawBytes) {
+        data->resize(packed);
+        data->shrink_to_fit();
+        entry.compressed = true;
+    }
+#endif
+    if (!entry.compressed) {
+        data->assign(reinterpret_cast<const char*>(src.data),
+                     reinterpret_cast<const char*>(src.data) + rawBytes);
+    }
+    entry.data = std::move(data);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto existing = entries_.find(key);
+    if (existing != entries_.end()) {
+        bytesStored_ -= existing->second->data->size();
+        bytesRaw_ -= existing->second->rawBytes();
+        lru_.erase(existing->second);
+        entries_.erase(existing);
+    }
+
+    bytesStored_ += entry.data->size();
+    bytesRaw_ += rawBytes;
+    lru_.push_front(std::move(entry));
+    entries_[key] = lru_.begin();
+    evictLocked();
+}
+
+void LumaCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    entries_.clear();
+    bytesStored_ = 0;
+    bytesRaw_ = 0;
+    hits_ = 0;
+    misses_ = 0;
+}
+
+LumaCache::Stats LumaCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats;
+    stats.entries = entries_.size();
+    stats.bytesStored = bytesStored_;
+    stats.bytesRaw = bytesRaw_;
+    stats.hits = hits_;
+    stats.misses = misses_;
+    return stats;
+}
+
+void LumaCache::evictLocked() {
+    while (bytesStored_ > budget_ && !lru_.empty()) {
+        const Entry& oldest = lru_.back();
+        bytesStored_ -= oldest.data->size();
+        bytesRaw_ -= oldest.rawBytes();
+        entries_.erase(oldest.key);
+        lru_.pop_back();
+    }
+}
+
+}  // namespace sharpctl
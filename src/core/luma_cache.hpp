@@ -0,0 +1,96 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace sharpctl {
+
+// Session cache of scoring luma (downscaled grayscale frames), so repeat
+// analyses of the same video with another algorithm or step skip decoding.
+// Frames are LZ4-compressed when built with LZ4 and stored raw otherwise;
+// the total stored size is bounded by a budget, evicting least recently
+// used frames. Thread-safe; compression runs outside the lock.
+class LumaCache {
+public:
+    static constexpr size_t kDefaultBudgetBytes = size_t(512) << 20;
+    // Largest scoring luma worth caching: about 1500 compressed 720p frames
+    // fit the default budget, while full-resolution 4K luma (8 MB a frame)
+    // would be evicted long before a rerun reached it
+    static constexpr size_t kMaxFramePixels = size_t(1280) * 720;
+
+    static bool admits(int width, int height) {
+        return static_cast<size_t>(width) * height <= kMaxFramePixels;
+    }
+
+    struct Key {
+        int frame = 0;
+        int reduction = 1;
+        int variant = 0;  // Distinguishes luma of the same frame from different inputs (e.g. proxy)
+
+        bool operator==(const Key& other) const {
+            return frame == other.frame && reduction == other.reduction && variant == other.variant;
+        }
+    };
+
+    struct Stats {
+        size_t entries = 0;
+        size_t bytesStored = 0;  // Compressed size
+        size_t bytesRaw = 0;     // Size the stored frames decompress to
+        size_t hits = 0;
+        size_t misses = 0;
+    };
+
+    explicit LumaCache(size_t budgetBytes = kDefaultBudgetBytes) : budget_(budgetBytes) {}
+
+    // Decompress a cached frame into `outGray`; false on a miss
+    bool get(const Key& key, cv::Mat& outGray);
+    // Whether a frame is cached, counting a miss if not (the caller decodes
+    // it instead); a later get() counts the hit
+    bool contains(const Key& key);
+
+    // Store a frame (copied), evicting old frames to stay within the budget
+    void put(const Key& key, const cv::Mat& gray);
+
+    void clear();
+    Stats getStats() const;
+
+    // Whether frames are compressed (built with LZ4)
+    static bool isCompressed();
+
+private:
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            return std::hash<long long>()((static_cast<long long>(key.frame) << 16) ^
+                                          (key.reduction << 4) ^ key.variant);
+        }
+    };
+
+    struct Entry {
+        Key key;
+        int rows = 0;
+        int cols = 0;
+        int type = 0;
+        bool compressed = false;
+        std::shared_ptr<const std::vector<char>> data;  // Shared so readers can decompress unlocked
+
+        size_t rawBytes() const { return static_cast<size_t>(rows) * cols * CV_ELEM_SIZE(type); }
+    };
+
+    void evictLocked();
+
+    std::list<Entry> lru_;  // Most recently used first
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> entries_;
+    const size_t budget_;  // Fixed, so put() can check it before locking
+    size_t bytesStored_ = 0;
+    size_t bytesRaw_ = 0;
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+    mutable std::mutex mutex_;
+};
+
+}  // namespace sharpctl
@@ -0,0 +1,91 @@
+#include "proxy_builder.hpp"
+#include "proxy_source.hpp"
+#include <filesystem>
+#include <algorithm>
+
+namespace fs = std::filesystem;
+
+namespace sharpctl {
+
+namespace {
+
+constexpr int kProxyJpegQuality = 85;
+
+}  // anonymous namespace
+
+ProxyBuilder::~ProxyBuilder() {
+    cancel();
+}
+
+bool ProxyBuilder::start(const FrameSource& source, const std::string& proxyPath, DoneCallback onDone) {
+    if (running_.load()) return false;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    std::unique_ptr<FrameSource> reader = source.clone();
+    if (!reader || !reader->isOpen()) return false;
+
+    cancelled_.store(false);
+    progress_.store(0.0f);
+    running_.store(true);
+    thread_ = std::thread([this, reader = std::move(reader), proxyPath, onDone = std::move(onDone)]() mutable {
+        run(std::move(reader), proxyPath, onDone);
+    });
+    return true;
+}
+
+void ProxyBuilder::cancel() {
+    cancelled_.store(true);
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void ProxyBuilder::run(std::unique_ptr<FrameSource> source, const std::string& proxyPath,
+                       const DoneCallback& onDone) {
+    const VideoInfo& info = source->getInfo();
+    const int height = std::min(ProxySource::kProxyHeight, info.height);
+    const int width = std::max(2, (info.width * height / std::max(info.height, 1)) & ~1);
+    const std::string partialPath = proxyPath + ".partial.avi";
+
+    cv::VideoWriter writer(partialPath, cv::CAP_OPENCV_MJPEG, cv::VideoWriter::fourcc('M', 'J', 'P', 'G'),
+                           info.fps > 0.0 ? info.fps : 25.0, cv::Size(width, height),
+                           {cv::VIDEOWRITER_PROP_QUALITY, kProxyJpegQuality});
+
+    // Every frame is written, in order, so proxy frame i is original frame i
+    bool ok = writer.isOpened() && info.frameCount > 0 && source->seekFrame(0);
+    int written = 0;
+    cv::Mat frame, small;
+    while (ok && written < info.frameCount && !cancelled_.load()) {
+        if (gate_) gate_->yield();
+        if (!source->readFrame(frame)) break;
+
+        if (frame.depth() == CV_16U) {
+            frame.convertTo(frame, CV_8U, 1.0 / 257.0);
+        }
+        cv::resize(frame, small, cv::Size(width, height), 0, 0, cv::INTER_AREA);
+        writer.write(small);
+
+        written++;
+        progress_.store(static_cast<float>(written) / info.frameCount);
+    }
+    writer.release();
+
+    ok = ok && !cancelled_.load() && written == info.frameCount;
+    std::error_code ec;
+    if (ok) {
+        fs::rename(partialPath, proxyPath, ec);
+        ok = !ec;
+    }
+    if (!ok) {
+        fs::remove(partialPath, ec);
+    }
+
+    running_.store(false);
+    if (onDone) {
+        onDone(ok);
+    }
+}
+
+}  // namespace sharpctl
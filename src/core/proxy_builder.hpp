@@ -0,0 +1,47 @@
+#pragma once
+
+#include "frame_source.hpp"
+#include "interactive_gate.hpp"
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+
+namespace sharpctl {
+
+// Background job writing a ProxySource file: every frame of the source,
+// downscaled to ProxySource::kProxyHeight and MJPEG-encoded. The file is
+// written under a temporary name and renamed when complete, so a proxy on
+// disk is always whole.
+class ProxyBuilder {
+public:
+    using DoneCallback = std::function<void(bool ok)>;
+
+    // With a gate, the builder yields to interactive work between frames
+    explicit ProxyBuilder(InteractiveGate* gate = nullptr) : gate_(gate) {}
+    ~ProxyBuilder();
+
+    ProxyBuilder(const ProxyBuilder&) = delete;
+    ProxyBuilder& operator=(const ProxyBuilder&) = delete;
+
+    // Start writing on a background thread, reading from a clone of `source`.
+    // `onDone` is called from that thread. Returns false if already running.
+    bool start(const FrameSource& source, const std::string& proxyPath, DoneCallback onDone = nullptr);
+
+    // Stop and wait for the thread; an unfinished file is removed
+    void cancel();
+
+    bool isRunning() const { return running_.load(); }
+    float getProgress() const { return progress_.load(); }
+
+private:
+    void run(std::unique_ptr<FrameSource> source, const std::string& proxyPath, const DoneCallback& onDone);
+
+    InteractiveGate* gate_ = nullptr;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> cancelled_{false};
+    std::atomic<float> progress_{0.0f};
+};
+
+}  // namespace sharpctl
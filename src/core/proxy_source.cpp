@@ -0,0 +1,95 @@
+#include "proxy_source.hpp"
+#include "video_capture_source.hpp"
+#include <filesystem>
+#include <algorithm>
+
+namespace fs = std::filesystem;
+
+namespace sharpctl {
+
+ProxySource::ProxySource(const FrameSource& original) {
+    const VideoInfo& info = original.getInfo();
+    auto times = std::make_shared<std::vector<double>>(info.frameCount);
+    for (int i = 0; i < info.frameCount; ++i) {
+        (*times)[i] = original.timeOfFrame(i);
+    }
+    times_ = std::move(times);
+    info_ = info;
+}
+
+ProxySource::~ProxySource() {
+    close();
+}
+
+bool ProxySource::open(const std::string& proxyPath) {
+    auto proxy = std::make_unique<VideoCaptureSource>();
+    if (!proxy->open(proxyPath)) return false;
+
+    // A proxy with a different frame count would shift every index
+    if (proxy->getInfo().frameCount != static_cast<int>(times_->size())) return false;
+
+    info_.width = proxy->getInfo().width;
+    info_.height = proxy->getInfo().height;
+    info_.bitDepth = 8;
+    proxy_ = std::move(proxy);
+    return true;
+}
+
+void ProxySource::close() {
+    proxy_.reset();
+}
+
+std::unique_ptr<FrameSource> ProxySource::clone() const {
+    std::unique_ptr<ProxySource> copy(new ProxySource());
+    copy->times_ = times_;
+    copy->info_ = info_;
+    if (proxy_) {
+        copy->proxy_ = proxy_->clone();
+    }
+    return copy;
+}
+
+bool ProxySource::seekFrame(int index) {
+    return proxy_ && proxy_->seekFrame(index);
+}
+
+int ProxySource::getPosition() const {
+    return proxy_ ? proxy_->getPosition() : 0;
+}
+
+bool ProxySource::readFrame(cv::Mat& outFrame) {
+    return proxy_ && proxy_->readFrame(outFrame);
+}
+
+bool ProxySource::skipFrame() {
+    return proxy_ && proxy_->skipFrame();
+}
+
+int ProxySource::frameAtTime(double timeSec) const {
+    const std::vector<double>& times = *times_;
+    if (times.empty()) return 0;
+
+    auto it = std::lower_bound(times.begin(), times.end(), timeSec);
+    if (it == times.end()) return static_cast<int>(times.size()) - 1;
+    if (it != times.begin() && (timeSec - *(it - 1)) < (*it - timeSec)) {
+        --it;
+    }
+    return static_cast<int>(it - times.begin());
+}
+
+double ProxySource::timeOfFrame(int index) const {
+    const std::vector<double>& times = *times_;
+    if (times.empty()) return 0.0;
+    return times[std::clamp(index, 0, static_cast<int>(times.size()) - 1)];
+}
+
+bool ProxySource::isCurrent(const std::string& proxyPath, const std::string& videoPath) {
+    std::error_code ec;
+    const auto proxyTime = fs::last_write_time(proxyPath, ec);
+    if (ec) return false;
+    const auto videoTime = fs::last_write_time(videoPath, ec);
+    if (ec) return false;
+    return proxyTime >= videoTime;
+}
+
+}  // namespace sharpctl
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "frame_source.hpp"
+
+namespace sharpctl {
+
+// Downscaled all-intra (MJPEG) copy of a video, written by ProxyBuilder next to
+// the original with exactly one frame per original frame. Every frame is a
+// keyframe, so random access costs a single small decode. Timing is taken
+// from the original, so frame indices and times match it exactly.
+class ProxySource : public FrameSource {
+public:
+    static constexpr int kProxyHeight = 540;
+
+    // Copies the original's frame timestamps; it need not outlive the proxy
+    explicit ProxySource(const FrameSource& original);
+    ~ProxySource() override;
+
+    // Open the proxy file; fails unless it holds one frame per original frame
+    bool open(const std::string& proxyPath) override;
+    void close() override;
+    bool isOpen() const override { return proxy_ && proxy_->isOpen(); }
+
+    // Reports the original's path, timing and frame count at proxy resolution
+    const VideoInfo& getInfo() const override { return info_; }
+
+    std::unique_ptr<FrameSource> clone() const override;
+
+    bool seekFrame(int index) override;
+    int getPosition() const override;
+    bool readFrame(cv::Mat& outFrame) override;
+    bool skipFrame() override;
+
+    int frameAtTime(double timeSec) const override;
+    double timeOfFrame(int index) const override;
+
+    // Whether a finished proxy exists that is newer than the video
+    static bool isCurrent(const std::string& proxyPath, const std::string& videoPath);
+
+private:
+    ProxySource() = default;
+
+    std::unique_ptr<FrameSource> proxy_;
+    std::shared_ptr<const std::vector<double>> times_;  // Original timestamps, shared with clones
+    VideoInfo info_;
+};
+
+}  // namespace sharpctl
@@ -0,0 +1,97 @@
+#include "throttle.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <thread>
+
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace sharpctl {
+
+namespace {
+
+constexpr int kBackgroundNice = 10;
+constexpr std::chrono::milliseconds kMinSleep{2};
+
+#ifdef __linux__
+// From linux/ioprio.h, which not every libc ships
+constexpr int kIoprioWhoProcess = 1;
+constexpr int kIoprioClassShift = 13;
+constexpr int kIoprioClassBestEffort = 2;
+constexpr int kIoprioLowestLevel = 7;
+
+// On Linux both calls with id 0 apply to the calling thread only
+bool setThreadPriority(int nice, int ioprio) {
+    const bool cpu = setpriority(PRIO_PROCESS, 0, nice) == 0;
+    const bool io = syscall(SYS_ioprio_set, kIoprioWhoProcess, 0, ioprio) == 0;
+    return cpu && io;
+}
+#endif
+
+}  // anonymous namespace
+
+bool lowerThreadPriority() {
+#ifdef __linux__
+    // Best effort at its lowest level rather than the idle class, which
+    // would stall the pass entirely while anything else reads the disk
+    return setThreadPriority(kBackgroundNice, (kIoprioClassBestEffort << kIoprioClassShift) | kIoprioLowestLevel);
+#else
+    return false;
+#endif
+}
+
+LowPriorityScope::LowPriorityScope(bool enable) {
+#ifdef __linux__
+    if (!enable) return;
+
+    // getpriority() may legitimately return -1
+    errno = 0;
+    const int nice = getpriority(PRIO_PROCESS, 0);
+    if (nice == -1 && errno != 0) return;
+    const long ioprio = syscall(SYS_ioprio_get, kIoprioWhoProcess, 0);
+    if (ioprio < 0) return;
+
+    savedNice_ = nice;
+    savedIoprio_ = static_cast<int>(ioprio);
+    active_ = true;
+
+    // A thread already below the background level stays there
+    const int lowest = (kIoprioClassBestEffort << kIoprioClassShift) | kIoprioLowestLevel;
+    setThreadPriority(std::max(nice, kBackgroundNice), lowest);
+#else
+    (void)enable;
+#endif
+}
+
+LowPriorityScope::~LowPriorityScope() {
+#ifdef __linux__
+    if (active_) {
+        setThreadPriority(savedNice_, savedIoprio_);
+    }
+#endif
+}
+
+DutyCycle::DutyCycle(int percent) : percent_(std::clamp(percent, kMinPercent, 100)) {}
+
+void DutyCycle::start() {
+    if (isActive()) {
+        workStart_ = std::chrono::steady_clock::now();
+    }
+}
+
+void DutyCycle::finish() {
+    if (!isActive()) return;
+
+    // Working p% of the time means resting (100 - p) / p of the work time
+    const auto worked = std::chrono::steady_clock::now() - workStart_;
+    owed_ += worked * (100 - percent_) / percent_;
+    if (owed_ >= kMinSleep) {
+        std::this_thread::sleep_for(owed_);
+        owed_ = std::chrono::steady_clock::duration::zero();
+    }
+}
+
+}  // namespace sharpctl
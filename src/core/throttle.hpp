@@ -0,0 +1,59 @@
+#pragma once
+
+#include <chrono>
+
+namespace sharpctl {
+
+// Lower the calling thread's CPU priority (nice 10) and I/O priority
+// (lowest best-effort level), so the rest of the desktop stays responsive
+// during a long pass. Threads it starts afterwards inherit both, but OpenMP
+// workers need not be among them (libomp keeps one pool for the process),
+// so pass workers lower themselves with LowPriorityScope. Unprivileged
+// processes usually cannot raise the nice value again, so call this on a
+// thread that only runs background work. Linux only; returns false where
+// unsupported or if either call failed.
+bool lowerThreadPriority();
+
+// Lowers the calling thread's priority like lowerThreadPriority() while in
+// scope, then restores both levels; for pooled threads such as OpenMP
+// workers. Raising the nice value back needs RLIMIT_NICE headroom or
+// CAP_SYS_NICE. Without it the worker stays at nice 10: with libgomp its
+// team ends with the thread that ran the pass, with libomp later passes
+// share that worker at the lower priority.
+class LowPriorityScope {
+public:
+    explicit LowPriorityScope(bool enable);
+    ~LowPriorityScope();
+
+    LowPriorityScope(const LowPriorityScope&) = delete;
+    LowPriorityScope& operator=(const LowPriorityScope&) = delete;
+
+private:
+    bool active_ = false;
+    int savedNice_ = 0;
+    int savedIoprio_ = 0;
+};
+
+// Caps one worker thread's CPU use at a share of wall time by sleeping
+// between units of work in proportion to the time they took. With every
+// worker capped at the same percentage, the whole pass uses about that
+// share of the machine.
+class DutyCycle {
+public:
+    static constexpr int kMinPercent = 5;
+
+    explicit DutyCycle(int percent);
+
+    bool isActive() const { return percent_ < 100; }
+
+    // Bracket one unit of work (e.g. a frame); finish() sleeps as needed
+    void start();
+    void finish();
+
+private:
+    int percent_;
+    std::chrono::steady_clock::time_point workStart_;
+    std::chrono::steady_clock::duration owed_{0};  // Sleep deferred until it is worth a syscall
+};
+
+}  // namespace sharpctl
@@ -1,65 +1,110 @@
 #include "video_analyzer.hpp"
+#include "video_capture_source.hpp"
+#include "proxy_source.hpp"
+#include "frame_pool.hpp"
 #include <filesystem>
+#include <algorithm>
 #include <cmath>
+#include <cstdio>
 #include <atomic>
+#include <chrono>
+#include <unordered_map>
 #include <omp.h>
 
 namespace fs = std::filesystem;
 
 namespace sharpctl {
 
+VideoAnalyzer::VideoAnalyzer() {
+    for (auto& stats : decoderStats_) {
+        stats = std::make_shared<DecoderStats>();
+    }
+}
+
 VideoAnalyzer::~VideoAnalyzer() {
     closeVideo();
 }
 
 bool VideoAnalyzer::openVideo(const std::string& path) {
-    std::lock_guard<std::recursive_mutex> lock(capMutex_);
+    closeVideo();
 
-    if (cap_.isOpened()) {
-        cap_.release();
-    }
-    videoInfo_ = VideoInfo{};
+    // Opening may scan the whole file for its frame index; other threads
+    // asking about the (closed) video meanwhile should not wait for that
+    return openSource(openFrameSource(path));
+}
 
-    cap_.open(path);
-    if (!cap_.isOpened()) {
+bool VideoAnalyzer::openSource(std::unique_ptr<FrameSource> source) {
+    if (!source || !source->isOpen()) {
         return false;
     }
 
-    videoInfo_.path = path;
-    videoInfo_.fps = cap_.get(cv::CAP_PROP_FPS);
-    videoInfo_.frameCount = static_cast<int>(cap_.get(cv::CAP_PROP_FRAME_COUNT));
-    videoInfo_.width = static_cast<int>(cap_.get(cv::CAP_PROP_FRAME_WIDTH));
-    videoInfo_.height = static_cast<int>(cap_.get(cv::CAP_PROP_FRAME_HEIGHT));
-
-    if (videoInfo_.fps > 0.0 && videoInfo_.frameCount > 0) {
-        videoInfo_.duration = videoInfo_.frameCount / videoInfo_.fps;
-    } else {
-        videoInfo_.duration = 0.0;
-    }
-
+    closeVideo();
+    std::lock_guard<std::recursive_mutex> lock(capMutex_);
+    source_ = std::move(source);
+    videoInfo_ = source_->getInfo();
     return true;
 }
 
 void VideoAnalyzer::closeVideo() {
+    proxyBuilder_.cancel();
     std::lock_guard<std::recursive_mutex> lock(capMutex_);
-    if (cap_.isOpened()) {
-        cap_.release();
-    }
+    proxy_.reset();
+    proxyBuilt_.store(false);
+    graphFromProxy_ = false;
+    decodeCosts_.clear();
+    lumaCache_.clear();
+    passFrames_.store(0);
+    passMicros_.store(0);
+    totalFrames_.store(0);
+    totalMicros_.store(0);
+    sideData_ = CodecSideData{};
+    sideDataProbed_ = false;
+    source_.reset();
     videoInfo_ = VideoInfo{};
+    for (auto& stats : decoderStats_) {
+        stats->reset();
+    }
+
+    // Idle buffers were sized for this video's frames
+    FramePool::instance().trim();
 }
 
 namespace {
 
-double calculateSharpnessLaplacian(const cv::Mat& gray) {
+int64_t toMicros(std::chrono::steady_clock::duration d) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+}
+
+constexpr int kMaxReduction = 8;
+
+// Reduction `info`'s frames are scored at when `requested` is asked for:
+// coarser if needed so the luma fits the cache and reruns skip decoding
+int scoringReduction(const VideoInfo& info, int requested) {
+    int reduction = std::max(1, requested);
+    while (reduction < kMaxReduction && !LumaCache::admits(info.width / reduction, info.height / reduction)) {
+        reduction *= 2;
+    }
+    return reduction;
+}
+
+// Whether scoring luma of `info`'s frames at `reduction` is cached
+bool lumaFitsCache(const VideoInfo& info, int reduction) {
+    return LumaCache::admits(info.width / reduction, info.height / reduction);
+}
+
+// valueScale maps the input range to 8-bit units so scores are comparable across bit depths
+double calculateSharpnessLaplacian(const cv::Mat& gray, double valueScale) {
+    // 3x3 Laplacian of 8-bit input stays within +/-1020, so 16-bit signed is exact;
+    // 16-bit input reaches +/-262140, still exact in float
     cv::Mat lap;
-    cv::Laplacian(gray, lap, CV_64F);
+    cv::Laplacian(gray, lap, gray.depth() == CV_8U ? CV_16S : CV_32F);
 
     cv::Scalar mean, stddev;
     cv::meanStdDev(lap, mean, stddev);
-    return stddev[0] * stddev[0];
+    return stddev[0] * stddev[0] * valueScale * valueScale;
 }
 
-double calculateSharpnessFFT(const cv::Mat& gray) {
+double calculateSharpnessFFT(const cv::Mat& gray, double valueScale) {
     // Pad to optimal DFT size
     cv::Mat padded;
     int m = cv::getOptimalDFTSize(gray.rows);
@@ -68,7 +113,9 @@ double calculateSharpnessFFT(const cv::Mat& gray) {
                        cv::BORDER_CONSTANT, cv::Scalar::all(0));
 
     // Create complex planes
-    cv::Mat planes[] = {cv::Mat_<float>(padded), cv::Mat::zeros(padded.size(), CV_32F)};
+    cv::Mat real;
+    padded.convertTo(real, CV_32F, valueScale);
+    cv::Mat planes[] = {real, cv::Mat::zeros(padded.size(), CV_32F)};
     cv::Mat complexImg;
     cv::merge(planes, 2, complexImg);
 
@@ -105,9 +152,20 @@ double calculateSharpnessFFT(const cv::Mat& gray) {
     return sum / (gray.rows * gray.cols);
 }
 
+std::vector<int> sortedUnique(std::vector<int> frames) {
+    std::sort(frames.begin(), frames.end());
+    frames.erase(std::unique(frames.begin(), frames.end()), frames.end());
+    return frames;
+}
+
+size_t slotOf(const std::vector<int>& sortedFrames, int frame) {
+    return static_cast<size_t>(std::lower_bound(sortedFrames.begin(), sortedFrames.end(), frame) -
+                               sortedFrames.begin());
+}
+
 }  // anonymous namespace
 
-double VideoAnalyzer::calculateSharpness(const cv::Mat& bgr, SharpnessAlgorithm algo) {
+double VideoAnalyzer::calculateSharpness(const cv::Mat& bgr, SharpnessAlgorithm algo, int bitDepth) {
     cv::Mat gray;
     if (bgr.channels() == 3) {
         cv::cvtColor(bgr, gray, cv::COLOR_BGR2GRAY);
@@ -115,80 +173,377 @@ double VideoAnalyzer::calculateSharpness(const cv::Mat& bgr, SharpnessAlgorithm
         gray = bgr;
     }
 
+    double valueScale = 1.0;
+    if (gray.depth() != CV_8U) {
+        const int bits = bitDepth > 8 ? bitDepth : 16;
+        valueScale = 255.0 / ((1 << bits) - 1);
+    }
+
     switch (algo) {
         case SharpnessAlgorithm::Laplacian:
-            return calculateSharpnessLaplacian(gray);
+            return calculateSharpnessLaplacian(gray, valueScale);
         case SharpnessAlgorithm::FFT:
         default:
-            return calculateSharpnessFFT(gray);
+            return calculateSharpnessFFT(gray, valueScale);
+    }
+}
+
+void VideoAnalyzer::makeThumbnail(const cv::Mat& frame, cv::Mat& outThumbnail) {
+    const int thumbHeight = 120;
+    const int thumbWidth = static_cast<int>(thumbHeight * frame.cols / frame.rows);
+    cv::resize(frame, outThumbnail, cv::Size(thumbWidth, thumbHeight));
+
+    // Thumbnails are for display only
+    if (outThumbnail.depth() == CV_16U) {
+        outThumbnail.convertTo(outThumbnail, CV_8U, 1.0 / 257.0);
+    }
+}
+
+std::string VideoAnalyzer::exportFilename(size_t index, const FrameData& frame, ExportFormat format) {
+    const char* ext = "jpg";
+    if (format == ExportFormat::PNG) ext = "png";
+    if (format == ExportFormat::TIFF) ext = "tif";
+
+    char filename[512];
+    std::snprintf(filename, sizeof(filename), "frame_%04zu_t%.3f_var%.2f.%s",
+                  index, frame.time, frame.sharpness, ext);
+    return filename;
+}
+
+bool VideoAnalyzer::writeFrame(const std::string& path, const cv::Mat& frame, ExportFormat format) {
+    // JPEG is 8-bit only; PNG and TIFF keep 16-bit frames as they are
+    if (format == ExportFormat::JPEG && frame.depth() == CV_16U) {
+        cv::Mat frame8;
+        frame.convertTo(frame8, CV_8U, 1.0 / 257.0);
+        return cv::imwrite(path, frame8);
     }
+    return cv::imwrite(path, frame);
+}
+
+int VideoAnalyzer::frameAtTime(double timeSec) const {
+    std::lock_guard<std::recursive_mutex> lock(capMutex_);
+    return isOpen() ? source_->frameAtTime(timeSec) : -1;
+}
+
+double VideoAnalyzer::timeOfFrame(int frameIndex) const {
+    std::lock_guard<std::recursive_mutex> lock(capMutex_);
+    return isOpen() ? source_->timeOfFrame(frameIndex) : 0.0;
 }
 
-bool VideoAnalyzer::getFrameAt(double timeSec, cv::Mat& outFrame) {
+std::unique_ptr<DecoderHandle> VideoAnalyzer::openDecoder(DecoderUse use, bool allowProxy) {
+    // Only the clone happens under the lock; decoding never does
     std::lock_guard<std::recursive_mutex> lock(capMutex_);
-    if (!cap_.isOpened()) return false;
+    if (!isOpen()) return nullptr;
+
+    std::shared_ptr<FrameSource> proxy = allowProxy ? proxySource() : nullptr;
+    std::unique_ptr<FrameSource> source = proxy ? proxy->clone() : source_->clone();
+    if (!source || !source->isOpen()) return nullptr;
+
+    auto decoder = std::make_unique<DecoderHandle>(std::move(source), statsFor(use), proxy != nullptr);
+    if (use != DecoderUse::Analysis && use != DecoderUse::Export) {
+        decoder->setAccessPattern(AccessPattern::Random);
+    }
+    return decoder;
+}
+
+std::unique_ptr<FrameSource> VideoAnalyzer::clonePassSource(const FrameSource* from) {
+    std::lock_guard<std::recursive_mutex> lock(capMutex_);
+    if (!isOpen()) return nullptr;
+
+    std::unique_ptr<FrameSource> source = from ? from->clone() : source_->clone();
+    if (!source || !source->isOpen()) return nullptr;
+    return source;
+}
+
+bool VideoAnalyzer::startProxy() {
+    std::lock_guard<std::recursive_mutex> lock(capMutex_);
+    if (!isOpen()) return false;
+    if (proxy_ || proxyBuilder_.isRunning()) return true;
+
+    // All-intra and uncompressed inputs already seek cheaply
+    const int keyframeCount = static_cast<int>(source_->keyframes().size());
+    if (keyframeCount == 0 || keyframeCount >= videoInfo_.frameCount) return false;
+
+    const std::string proxyPath = getProxyPath(videoInfo_.path);
+    if (ProxySource::isCurrent(proxyPath, videoInfo_.path)) {
+        proxyBuilt_.store(true);
+        if (proxySource()) return true;
+    }
+
+    proxyBuilt_.store(false);
+    return proxyBuilder_.start(*source_, proxyPath, [this](bool ok) { proxyBuilt_.store(ok); });
+}
+
+std::shared_ptr<FrameSource> VideoAnalyzer::proxySource() {
+    std::lock_guard<std::recursive_mutex> lock(capMutex_);
+    if (!proxy_ && proxyBuilt_.load() && isOpen()) {
+        auto proxy = std::make_shared<ProxySource>(*source_);
+        if (proxy->open(getProxyPath(videoInfo_.path))) {
+            proxy_ = std::move(proxy);
+        } else {
+            proxyBuilt_.store(false);  // Stale or truncated; startProxy() rebuilds it
+        }
+    }
+    return proxy_;
+}
+
+DecodePlan VideoAnalyzer::planFrames(const FrameSource& source, int variant, const std::vector<int>& frames) {
+    auto costs = decodeCosts_.find(variant);
+    if (costs == decodeCosts_.end()) {
+        costs = decodeCosts_.emplace(variant, measureDecodeCosts(source)).first;
+    }
+
+    // A few runs per worker keeps dynamic scheduling balanced
+    const int threads = omp_get_max_threads();
+    DecodePlan plan = planDecode(frames, source, costs->second, static_cast<size_t>(threads) * 4);
+    if (planCb_) {
+        planCb_(plan, threads);
+    }
+    return plan;
+}
+
+bool VideoAnalyzer::ensureCodecSideData(const ProgressCallback& progressCb) {
+    if (!sideDataProbed_) {
+        // Only compressed video carries motion vectors and quantizers. A
+        // cancelled probe is retried by the next pass that wants it.
+        if (codecSideDataAvailable() && dynamic_cast<VideoCaptureSource*>(source_.get())) {
+            probeCodecSideData(videoInfo_.path, *source_, sideData_, [&](float progress) {
+                gate_.yield();
+                if (progressCb) progressCb(progress, "Reading codec side data (extra decode pass)...");
+                return !isCancelled();
+            });
+        }
+        if (isCancelled()) {
+            sideData_ = CodecSideData{};
+        } else {
+            sideDataProbed_ = true;
+        }
+    }
+    return !sideData_.empty();
+}
+
+void VideoAnalyzer::runPlan(const FrameSource& source, DecoderUse use, const DecodePlan& plan,
+                            const std::function<void(FrameSource& source, size_t slot)>& visit) {
+    const int totalRuns = static_cast<int>(plan.runs.size());
+    const auto runStart = std::chrono::steady_clock::now();
+    runStartMicros_.store(toMicros(runStart.time_since_epoch()));
+
+    #pragma omp parallel
+    {
+        // Each thread gets its own source handle (decoders are not thread-safe)
+        std::unique_ptr<FrameSource> localSource = source.clone();
+        if (localSource) {
+            localSource = std::make_unique<DecoderHandle>(std::move(localSource), statsFor(use));
+        }
+        LowPriorityScope priority(lowPriority_);
+        DutyCycle duty(cpuCapPercent_);
+
+        #pragma omp for schedule(dynamic)
+        for (int r = 0; r < totalRuns; ++r) {
+            const DecodeRun& run = plan.runs[r];
+            for (size_t slot = run.begin; localSource && slot < run.end && !isCancelled(); ++slot) {
+                const int frame = plan.frames[slot];
+                gate_.yield();
+                duty.start();
+
+                // Seek at the start of a run, decode forward within it
+                bool positioned = slot == run.begin && localSource->seekFrame(frame);
+                if (slot != run.begin) {
+                    positioned = true;
+                    while (positioned && localSource->getPosition() < frame) {
+                        positioned = localSource->skipFrame();
+                    }
+                }
+                if (positioned && localSource->getPosition() == frame) {
+                    visit(*localSource, slot);
+                    passFrames_.fetch_add(1, std::memory_order_relaxed);
+                }
+                duty.finish();
+            }
+        }
+    }
+
+    passMicros_.fetch_add(toMicros(std::chrono::steady_clock::now() - runStart));
+    runStartMicros_.store(0);
+}
+
+void VideoAnalyzer::startPass(int cpuCapPercent, bool lowPriority) {
+    cpuCapPercent_ = cpuCapPercent;
+    lowPriority_ = lowPriority;
+    totalFrames_.fetch_add(passFrames_.exchange(0));
+    totalMicros_.fetch_add(passMicros_.exchange(0));
+}
+
+VideoAnalyzer::Throughput VideoAnalyzer::getThroughput() const {
+    Throughput throughput;
+    throughput.frames = passFrames_.load(std::memory_order_relaxed);
+    int64_t micros = passMicros_.load();
+    const int64_t runStart = runStartMicros_.load();
+    if (runStart > 0) {
+        micros += toMicros(std::chrono::steady_clock::now().time_since_epoch()) - runStart;
+    }
+    throughput.seconds = micros / 1e6;
+    throughput.cpuCapPercent = cpuCapPercent_;
+    return throughput;
+}
+
+VideoAnalyzer::Throughput VideoAnalyzer::getTotalThroughput() const {
+    Throughput throughput = getThroughput();
+    throughput.frames += totalFrames_.load(std::memory_order_relaxed);
+    throughput.seconds += totalMicros_.load() / 1e6;
+    return throughput;
+}
+
+int VideoAnalyzer::scoringReductionFor(int reduction) const {
+    return scoringReduction(videoInfo_, reduction);
+}
+
+bool VideoAnalyzer::readLumaForward(FrameSource& decoder, int variant, int frame, int reduction,
+                                    cv::Mat& outGray) {
+    reduction = scoringReduction(decoder.getInfo(), reduction);
+    const LumaCache::Key key{frame, reduction, variant};
+    const bool cached = lumaFitsCache(decoder.getInfo(), reduction);
+    if (cached && lumaCache_.get(key, outGray)) return true;
+
+    const int position = decoder.getPosition();
+    bool positioned = true;
+    if (position > frame || decoder.keyframeAtOrBefore(frame) > position) {
+        positioned = decoder.seekFrame(frame);
+    }
+    while (positioned && decoder.getPosition() < frame) {
+        positioned = decoder.skipFrame();
+    }
+    if (!positioned || decoder.getPosition() != frame || !decoder.readLuma(outGray, reduction)) {
+        return false;
+    }
+    if (cached) {
+        lumaCache_.put(key, outGray);
+    }
+    return true;
+}
+
+void VideoAnalyzer::visitLuma(FrameSource& source, int variant, const std::vector<int>& frames,
+                              int reduction, const LumaVisitor& visit) {
+    // Serve cached frames without decoding
+    reduction = scoringReduction(source.getInfo(), reduction);
+    const bool cached = lumaFitsCache(source.getInfo(), reduction);
+    std::vector<size_t> hits;
+    std::vector<int> misses;
+    for (size_t i = 0; i < frames.size(); ++i) {
+        if (cached && lumaCache_.contains({frames[i], reduction, variant})) {
+            hits.push_back(i);
+        } else {
+            misses.push_back(frames[i]);
+        }
+    }
+
+    #pragma omp parallel
+    {
+        LowPriorityScope priority(lowPriority_);
+
+        #pragma omp for schedule(dynamic)
+        for (int h = 0; h < static_cast<int>(hits.size()); ++h) {
+            if (isCancelled()) continue;
 
-    cap_.set(cv::CAP_PROP_POS_MSEC, timeSec * 1000.0);
-    return cap_.read(outFrame);
+            const size_t i = hits[h];
+            cv::Mat gray;
+            if (lumaCache_.get({frames[i], reduction, variant}, gray)) {
+                visit(i, gray);
+            } else {
+                #pragma omp critical(luma_misses)
+                misses.push_back(frames[i]);
+            }
+        }
+    }
+
+    if (misses.empty() || isCancelled()) return;
+
+    // Decode the rest, keeping their luma for the next analysis
+    const DecodePlan plan = planFrames(source, variant, misses);
+    source.prefetch(plan.frames);
+
+    runPlan(source, DecoderUse::Analysis, plan, [&](FrameSource& localSource, size_t slot) {
+        cv::Mat gray;
+        if (localSource.readLuma(gray, reduction)) {
+            if (cached) {
+                lumaCache_.put({plan.frames[slot], reduction, variant}, gray);
+            }
+            visit(slotOf(frames, plan.frames[slot]), gray);
+        }
+    });
+
+    source.prefetch({});
 }
 
 bool VideoAnalyzer::analyzeFullVideo(const AnalysisParams& params,
                                      std::vector<FrameData>& outSamples,
                                      ProgressCallback progressCb,
                                      SampleCallback sampleCb) {
-    if (!cap_.isOpened()) return false;
+    if (!isOpen()) return false;
 
     outSamples.clear();
     resetCancel();
+    startPass(params.cpuCapPercent, params.lowPriority);
 
     const double duration = videoInfo_.duration;
     if (duration <= 0.0) return false;
 
     const double step = static_cast<double>(params.sampleStepSec);
 
-    // Pre-compute sample times
-    std::vector<double> sampleTimes;
-    for (double t = 0.0; t <= duration; t += step) {
-        sampleTimes.push_back(t);
+    // Pre-compute the frames to sample: every keyframe in keyframe mode (cost
+    // then scales with the keyframe count), otherwise the frames the sample
+    // times map to. Inputs without keyframes are sampled by time either way.
+    std::vector<int> sampleFrames;
+    if (params.scanMode == ScanMode::Keyframes) {
+        sampleFrames = source_->keyframes();
+    }
+    if (sampleFrames.empty()) {
+        for (double t = 0.0; t <= duration; t += step) {
+            sampleFrames.push_back(source_->frameAtTime(t));
+        }
     }
 
-    const size_t totalSamples = sampleTimes.size();
-    std::vector<FrameData> results(totalSamples);
-    std::atomic<int> completed{0};
-
-    #pragma omp parallel
-    {
-        // Each thread opens its own VideoCapture (cv::VideoCapture is not thread-safe)
-        cv::VideoCapture localCap(videoInfo_.path);
+    // Motion curve for the timeline comes with the prefilter's side data
+    const bool haveSideData = params.codecPrefilter && ensureCodecSideData(progressCb);
+    if (isCancelled()) return false;
 
-        #pragma omp for schedule(dynamic)
-        for (size_t i = 0; i < totalSamples; ++i) {
-            if (isCancelled()) continue;
+    // The graph only needs the curve's shape, so it runs on the proxy when one is ready
+    std::shared_ptr<FrameSource> proxy = params.useProxy ? proxySource() : nullptr;
+    std::unique_ptr<FrameSource> pass = clonePassSource(proxy.get());
+    if (!pass) return false;
+    FrameSource& graphSource = *pass;
+    graphFromProxy_ = proxy != nullptr;
 
-            double t = sampleTimes[i];
-            cv::Mat frame;
-            localCap.set(cv::CAP_PROP_POS_MSEC, t * 1000.0);
-            if (localCap.read(frame)) {
-                results[i].time = t;
-                results[i].sharpness = calculateSharpness(frame, params.algorithm);
-                results[i].selected = false;
-            } else {
-                results[i].sharpness = -1.0;  // Mark as invalid
-            }
+    const std::vector<int> frames = sortedUnique(sampleFrames);
+    const size_t totalSamples = frames.size();
+    std::vector<FrameData> results(totalSamples);
+    std::atomic<int> completed{0};
 
-            int done = ++completed;
-            #pragma omp critical
-            {
-                if (progressCb && (done % 10 == 0 || done == static_cast<int>(totalSamples))) {
-                    progressCb(static_cast<float>(done) / totalSamples, "Analyzing video...");
-                }
+    // Let the backend read ahead in the order the workers will consume
+    graphSource.setAccessPattern(step * videoInfo_.fps > 1.5 ? AccessPattern::Random
+                                                             : AccessPattern::Sequential);
+
+    visitLuma(graphSource, proxy ? kProxyVariant : kOriginalVariant, frames, params.decodeReduction,
+              [&](size_t i, const cv::Mat& gray) {
+        // Report the frame's own timestamp rather than the nominal sample time
+        results[i].time = graphSource.timeOfFrame(frames[i]);
+        results[i].frameIndex = frames[i];
+        results[i].sharpness = calculateSharpness(gray, params.algorithm, videoInfo_.bitDepth);
+        results[i].motion = haveSideData ? sideData_.motionAt(frames[i]) : -1.0f;
+        results[i].selected = false;
+
+        int done = ++completed;
+        #pragma omp critical
+        {
+            if (progressCb && (done % 10 == 0 || done == static_cast<int>(totalSamples))) {
+                progressCb(static_cast<float>(done) / totalSamples, "Analyzing video...");
             }
         }
-    }
+    });
 
     // Collect valid results (samples arrive out-of-order, so no live sampleCb during parallel)
     for (const auto& r : results) {
-        if (r.sharpness >= 0.0) {
+        if (r.frameIndex >= 0 && r.sharpness >= 0.0) {
             outSamples.push_back(r);
             if (sampleCb) {
                 sampleCb(r);
@@ -203,15 +558,88 @@ bool VideoAnalyzer::analyzeFullVideo(const AnalysisParams& params,
     return !isCancelled();
 }
 
+bool VideoAnalyzer::scoreFrames(const AnalysisParams& params, const std::vector<int>& frames,
+                                const RefineVisitor& visit) {
+    const bool fromProxy = graphFromProxy_;
+    std::unique_ptr<DecoderHandle> decoder = openDecoder(DecoderUse::Refine, fromProxy);
+    if (!decoder || decoder->isProxy() != fromProxy) return false;
+
+    const int variant = fromProxy ? kProxyVariant : kOriginalVariant;
+    const int reduction = params.decodeReduction;
+    const bool haveSideData = params.codecPrefilter && !sideData_.empty();
+    decoder->setAccessPattern(AccessPattern::Sequential);
+
+    for (int frame : frames) {
+        gate_.yield();
+
+        cv::Mat gray;
+        if (!readLumaForward(*decoder, variant, frame, reduction, gray)) continue;
+
+        FrameData sample;
+        sample.time = decoder->timeOfFrame(frame);
+        sample.frameIndex = frame;
+        sample.sharpness = calculateSharpness(gray, params.algorithm, videoInfo_.bitDepth);
+        sample.motion = haveSideData ? sideData_.motionAt(frame) : -1.0f;
+        sample.selected = false;
+        if (!visit(sample)) return false;
+    }
+    return true;
+}
+
+bool VideoAnalyzer::findSharpestNear(FrameSource& decoder, const AnalysisParams& params, double timeSec,
+                                     double windowSec, const std::unordered_map<int, double>& known,
+                                     FrameData& out) {
+    // The decoder's own input decides the window, so this works on any handle
+    const VideoInfo& info = decoder.getInfo();
+    const double duration = info.duration;
+    const int first = decoder.frameAtTime(std::max(0.0, timeSec - windowSec));
+    const int last = decoder.frameAtTime(std::min(duration, timeSec + windowSec));
+    if (first < 0 || last < first) return false;
+
+    // Every frame of the window, front to back (earliest wins ties)
+    decoder.setAccessPattern(AccessPattern::Sequential);
+    double bestScore = -1.0;
+    int bestIndex = -1;
+    for (int frame = first; frame <= last; ++frame) {
+        double score;
+        auto cached = known.find(frame);
+        if (cached != known.end()) {
+            score = cached->second;
+        } else {
+            cv::Mat gray;
+            if (!readLumaForward(decoder, kOriginalVariant, frame, params.decodeReduction, gray)) continue;
+            score = calculateSharpness(gray, params.algorithm, info.bitDepth);
+        }
+        if (score > bestScore) {
+            bestScore = score;
+            bestIndex = frame;
+        }
+    }
+    if (bestIndex < 0) return false;
+
+    cv::Mat frame;
+    decoder.setAccessPattern(AccessPattern::Random);
+    if (!decoder.getFrame(bestIndex, frame)) return false;
+
+    out = FrameData{};
+    out.time = decoder.timeOfFrame(bestIndex);
+    out.frameIndex = bestIndex;
+    out.sharpness = bestScore;
+    out.selected = true;
+    makeThumbnail(frame, out.thumbnail);
+    return true;
+}
+
 bool VideoAnalyzer::findOptimalFrames(const AnalysisParams& params,
                                       const std::vector<FrameData>& allSamples,
                                       std::vector<FrameData>& outSelected,
                                       ProgressCallback progressCb,
                                       SearchCallback searchCb) {
-    if (!cap_.isOpened()) return false;
+    if (!isOpen()) return false;
 
     outSelected.clear();
     resetCancel();
+    startPass(params.cpuCapPercent, params.lowPriority);
 
     const double duration = videoInfo_.duration;
     if (duration <= 0.0) return false;
@@ -220,73 +648,143 @@ bool VideoAnalyzer::findOptimalFrames(const AnalysisParams& params,
     const double window = static_cast<double>(params.searchWindowSec);
     const double step = static_cast<double>(params.searchStepSec);
 
-    // Pre-compute target times
-    std::vector<double> targetTimes;
-    for (double t = 0.0; t <= duration; t += interval) {
-        targetTimes.push_back(t);
+    std::vector<int> keyframes;
+    if (params.scanMode == ScanMode::Keyframes) {
+        keyframes = source_->keyframes();
     }
 
-    const size_t totalTargets = targetTimes.size();
-    std::vector<FrameData> results(totalTargets);
-    std::atomic<int> completed{0};
-
-    #pragma omp parallel
-    {
-        // Each thread opens its own VideoCapture
-        cv::VideoCapture localCap(videoInfo_.path);
+    const bool prefilter = params.codecPrefilter && ensureCodecSideData(progressCb);
+    if (isCancelled()) return false;
 
-        #pragma omp for schedule(dynamic)
-        for (size_t i = 0; i < totalTargets; ++i) {
-            if (isCancelled()) continue;
+    // Keyframe mode reuses the keyframe scores of the graph pass (unless
+    // those came from the proxy; selection always scores the original)
+    std::unordered_map<int, double> knownScores;
+    if (!keyframes.empty() && !graphFromProxy_) {
+        for (const auto& sample : allSamples) {
+            if (sample.frameIndex >= 0) {
+                knownScores[sample.frameIndex] = sample.sharpness;
+            }
+        }
+    }
 
-            double targetT = targetTimes[i];
-            double bestVar = -1.0;
-            double bestTime = targetT;
-            cv::Mat bestFrame;
-
-            const double startT = std::max(0.0, targetT - window);
-            const double endT = std::min(duration, targetT + window);
-
-            for (double ts = startT; ts <= endT + 1e-9 && !isCancelled(); ts += step) {
-                cv::Mat frame;
-                localCap.set(cv::CAP_PROP_POS_MSEC, ts * 1000.0);
-                if (localCap.read(frame)) {
-                    double v = calculateSharpness(frame, params.algorithm);
-                    if (v > bestVar) {
-                        bestVar = v;
-                        bestTime = ts;
-                        bestFrame = frame.clone();
-                    }
+    // Candidate frames of each search window, in time order. Steps finer than
+    // the frame rate map to the same frame.
+    std::vector<std::vector<int>> candidates;
+    std::vector<int> toScore;
+    for (double targetT = 0.0; targetT <= duration; targetT += interval) {
+        const double startT = std::max(0.0, targetT - window);
+        const double endT = std::min(duration, targetT + window);
+
+        std::vector<int> frames;
+        if (!keyframes.empty()) {
+            // Keyframes inside the window, or the nearest one when the window falls within a GOP
+            auto first = std::lower_bound(keyframes.begin(), keyframes.end(), source_->frameAtTime(startT));
+            auto last = std::upper_bound(keyframes.begin(), keyframes.end(), source_->frameAtTime(endT));
+            if (first != last) {
+                frames.assign(first, last);
+            } else {
+                const int target = source_->frameAtTime(targetT);
+                const int before = source_->keyframeAtOrBefore(target);
+                const bool useNext = last != keyframes.end() && *last - target < target - before;
+                frames.push_back(useNext ? *last : before);
+            }
+        } else {
+            for (double ts = startT; ts <= endT + 1e-9; ts += step) {
+                const int index = source_->frameAtTime(ts);
+                if (frames.empty() || frames.back() != index) {
+                    frames.push_back(index);
                 }
             }
+        }
 
-            if (!bestFrame.empty()) {
-                results[i].time = bestTime;
-                results[i].sharpness = bestVar;
-                results[i].selected = true;
+        // Drop likely losers before any pixel is decoded
+        if (prefilter) {
+            frames = sideData_.prefilter(frames);
+        }
 
-                // Create thumbnail
-                const int thumbHeight = 120;
-                const int thumbWidth = static_cast<int>(thumbHeight * bestFrame.cols / bestFrame.rows);
-                cv::resize(bestFrame, results[i].thumbnail, cv::Size(thumbWidth, thumbHeight));
+        for (int index : frames) {
+            if (!knownScores.count(index)) {
+                toScore.push_back(index);
             }
+        }
+        candidates.push_back(std::move(frames));
+    }
 
-            int done = ++completed;
-            #pragma omp critical
-            {
-                if (progressCb && (done % 5 == 0 || done == static_cast<int>(totalTargets))) {
-                    progressCb(static_cast<float>(done) / totalTargets, "Finding optimal frames...");
-                }
+    // Score every candidate once; overlapping windows share frames
+    const std::vector<int> frames = sortedUnique(toScore);
+    const size_t totalCandidates = frames.size();
+    std::vector<double> scores(totalCandidates, -1.0);
+    std::atomic<int> completed{0};
+
+    // Windows are scanned front to back
+    std::unique_ptr<FrameSource> pass = clonePassSource();
+    if (!pass) return false;
+    pass->setAccessPattern(AccessPattern::Sequential);
+
+    // Score on the same luma path as the graph so values are comparable
+    visitLuma(*pass, kOriginalVariant, frames, params.decodeReduction,
+              [&](size_t i, const cv::Mat& gray) {
+        scores[i] = calculateSharpness(gray, params.algorithm, videoInfo_.bitDepth);
+
+        int done = ++completed;
+        #pragma omp critical
+        {
+            if (progressCb && (done % 5 == 0 || done == static_cast<int>(totalCandidates))) {
+                progressCb(0.9f * done / totalCandidates, "Finding optimal frames...");
             }
         }
+    });
+
+    if (isCancelled()) return false;
+
+    // Pick the sharpest candidate of each window (earliest on ties)
+    std::vector<int> winners;
+    for (const auto& windowFrames : candidates) {
+        double bestVar = -1.0;
+        int bestIndex = -1;
+        for (int index : windowFrames) {
+            auto known = knownScores.find(index);
+            const double v = known != knownScores.end() ? known->second : scores[slotOf(frames, index)];
+            if (v > bestVar) {
+                bestVar = v;
+                bestIndex = index;
+            }
+        }
+        if (bestIndex >= 0) {
+            FrameData fd;
+            fd.time = source_->timeOfFrame(bestIndex);
+            fd.frameIndex = bestIndex;
+            fd.sharpness = bestVar;
+            fd.motion = prefilter ? sideData_.motionAt(bestIndex) : -1.0f;
+            fd.selected = true;
+            outSelected.push_back(fd);
+            winners.push_back(bestIndex);
+        }
     }
 
-    // Collect non-empty results (searchCb disabled during parallel mode)
-    for (const auto& r : results) {
-        if (!r.thumbnail.empty()) {
-            outSelected.push_back(r);
+    // Decode the winners once in colour for their thumbnails
+    const DecodePlan thumbPlan = planFrames(*pass, kOriginalVariant, winners);
+    std::vector<cv::Mat> thumbnails(thumbPlan.frames.size());
+    pass->setAccessPattern(AccessPattern::Random);
+
+    runPlan(*pass, DecoderUse::Analysis, thumbPlan, [&](FrameSource& localSource, size_t slot) {
+        cv::Mat frame;
+        if (localSource.readFrame(frame)) {
+            makeThumbnail(frame, thumbnails[slot]);
+        }
+    });
+
+    // Keep only frames that could be decoded. Adjacent windows may pick the
+    // same frame; they share its thumbnail buffer (thumbnails are read-only).
+    std::vector<FrameData> decoded;
+    for (auto& fd : outSelected) {
+        const cv::Mat& thumbnail = thumbnails[thumbPlan.slotOf(fd.frameIndex)];
+        if (!thumbnail.empty()) {
+            fd.thumbnail = thumbnail;
+            decoded.push_back(fd);
         }
     }
+    outSelected = std::move(decoded);
 
     // Clear search state when done
     if (searchCb) {
@@ -302,59 +800,62 @@ bool VideoAnalyzer::findOptimalFrames(const AnalysisParams& params,
 
 bool VideoAnalyzer::exportFrames(const std::vector<FrameData>& frames,
                                  const std::string& outputDir,
+                                 ExportFormat format,
                                  ProgressCallback progressCb) {
-    if (!cap_.isOpened()) return false;
+    if (!isOpen()) return false;
 
     resetCancel();
+    startPass(100, false);
     fs::create_directories(outputDir);
 
-    // Collect frames to export with their indices
-    std::vector<std::pair<size_t, const FrameData*>> toExport;
-    for (size_t i = 0; i < frames.size(); ++i) {
-        if (frames[i].selected) {
-            toExport.emplace_back(toExport.size(), &frames[i]);
+    // Collect frames to export with their output numbers and frame indices
+    std::vector<const FrameData*> toExport;
+    std::vector<int> exportIndices;
+    for (const auto& frame : frames) {
+        if (frame.selected) {
+            toExport.push_back(&frame);
+            exportIndices.push_back(frame.frameIndex >= 0 ? frame.frameIndex
+                                                         : source_->frameAtTime(frame.time));
         }
     }
 
+    std::unique_ptr<FrameSource> pass = clonePassSource();
+    if (!pass) return false;
+    const DecodePlan plan = planFrames(*pass, kOriginalVariant, exportIndices);
+
+    // Outputs per decoded frame (two selections can resolve to the same frame)
+    std::vector<std::vector<size_t>> outputsBySlot(plan.frames.size());
+    for (size_t i = 0; i < toExport.size(); ++i) {
+        outputsBySlot[plan.slotOf(exportIndices[i])].push_back(i);
+    }
+
     const size_t totalExport = toExport.size();
     std::atomic<int> completed{0};
     std::atomic<bool> failed{false};
 
-    #pragma omp parallel
-    {
-        // Each thread opens its own VideoCapture
-        cv::VideoCapture localCap(videoInfo_.path);
+    pass->setAccessPattern(AccessPattern::Random);
 
-        #pragma omp for schedule(dynamic)
-        for (size_t i = 0; i < totalExport; ++i) {
-            if (isCancelled() || failed.load()) continue;
-
-            size_t index = toExport[i].first;
-            const FrameData* fd = toExport[i].second;
-
-            cv::Mat frame;
-            localCap.set(cv::CAP_PROP_POS_MSEC, fd->time * 1000.0);
-            if (localCap.read(frame)) {
-                char filename[512];
-                std::snprintf(filename, sizeof(filename),
-                              "frame_%04zu_t%.3f_var%.2f.jpg",
-                              index, fd->time, fd->sharpness);
-
-                const fs::path outPath = fs::path(outputDir) / filename;
-                if (!cv::imwrite(outPath.string(), frame)) {
+    runPlan(*pass, DecoderUse::Export, plan, [&](FrameSource& localSource, size_t slot) {
+        if (failed.load()) return;
+
+        cv::Mat frame;
+        if (localSource.readFrame(frame)) {
+            for (size_t index : outputsBySlot[slot]) {
+                const fs::path outPath = fs::path(outputDir) / exportFilename(index, *toExport[index], format);
+                if (!writeFrame(outPath.string(), frame, format)) {
                     failed.store(true);
                 }
             }
+        }
 
-            int done = ++completed;
-            #pragma omp critical
-            {
-                if (progressCb && (done % 5 == 0 || done == static_cast<int>(totalExport))) {
-                    progressCb(static_cast<float>(done) / totalExport, "Exporting frames...");
-                }
+        int done = (completed += static_cast<int>(outputsBySlot[slot].size()));
+        #pragma omp critical
+        {
+            if (progressCb) {
+                progressCb(static_cast<float>(done) / totalExport, "Exporting frames...");
             }
         }
-    }
+    });
 
     if (failed.load()) {
         return false;
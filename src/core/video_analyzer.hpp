@@ -1,11 +1,21 @@
 #pragma once
 
 #include "frame_data.hpp"
+#include "frame_source.hpp"
+#include "decode_planner.hpp"
+#include "codec_side_data.hpp"
+#include "proxy_builder.hpp"
+#include "luma_cache.hpp"
+#include "decoder_handle.hpp"
+#include "interactive_gate.hpp"
+#include "throttle.hpp"
 #include <opencv2/opencv.hpp>
 #include <functional>
 #include <atomic>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
 
 namespace sharpctl {
 
@@ -15,23 +25,55 @@ public:
     using SampleCallback = std::function<void(const FrameData& sample)>;
     // SearchCallback: windowStart, windowEnd, currentTime, bestTime, bestSharpness
     using SearchCallback = std::function<void(double, double, double, double, double)>;
+    using PlanCallback = std::function<void(const DecodePlan& plan, int threads)>;
 
-    VideoAnalyzer() = default;
+    VideoAnalyzer();
     ~VideoAnalyzer();
 
-    // Open a video file
+    // Open a video file or image sequence directory
     bool openVideo(const std::string& path);
+    // Analyze an already opened source (another backend, or a test input)
+    bool openSource(std::unique_ptr<FrameSource> source);
     void closeVideo();
-    bool isOpen() const { return cap_.isOpened(); }
+    bool isOpen() const { return source_ && source_->isOpen(); }
 
     // Get video information
     const VideoInfo& getVideoInfo() const { return videoInfo_; }
 
-    // Calculate sharpness using specified algorithm
-    static double calculateSharpness(const cv::Mat& frame, SharpnessAlgorithm algo = SharpnessAlgorithm::Laplacian);
+    // Whether the input has keyframe flags. Without them seeks are not
+    // planned, keyframe scans sample by time and no scrub proxy is built.
+    bool hasKeyframes() const { return isOpen() && !source_->keyframes().empty(); }
 
-    // Get a single frame at a specific time
-    bool getFrameAt(double timeSec, cv::Mat& outFrame);
+    // Calculate sharpness using specified algorithm. Accepts 8-bit or 16-bit
+    // BGR/luma; bitDepth gives the significant bits of 16-bit input so scores
+    // stay in 8-bit units regardless of precision.
+    static double calculateSharpness(const cv::Mat& frame, SharpnessAlgorithm algo = SharpnessAlgorithm::Laplacian,
+                                     int bitDepth = 8);
+
+    // Create an 8-bit display thumbnail of a frame
+    static void makeThumbnail(const cv::Mat& frame, cv::Mat& outThumbnail);
+
+    // File name and writer used for exported frames
+    static std::string exportFilename(size_t index, const FrameData& frame, ExportFormat format);
+    static bool writeFrame(const std::string& path, const cv::Mat& frame, ExportFormat format);
+
+    // Map between presentation time and frame index
+    int frameAtTime(double timeSec) const;
+    double timeOfFrame(int frameIndex) const;
+
+    // Independent decoder for one consumer, so no consumer's seeks wait on
+    // another's. Its seeks and decode time count towards `use`. With
+    // `allowProxy` it decodes the scrub proxy once one is ready (see
+    // DecoderHandle::isProxy). Null while no video is open.
+    std::unique_ptr<DecoderHandle> openDecoder(DecoderUse use, bool allowProxy = false);
+    DecoderStats::Snapshot getDecoderStats(DecoderUse use) const { return statsFor(use)->get(); }
+
+    // Use an existing scrub proxy or start building one in the background.
+    // Only long-GOP video gets a proxy; returns false when none is needed.
+    bool startProxy();
+    bool hasProxy() { return proxySource() != nullptr; }
+    bool isBuildingProxy() const { return proxyBuilder_.isRunning(); }
+    float getProxyProgress() const { return proxyBuilder_.getProgress(); }
 
     // Analyze full video to get sharpness data for graph
     // This samples at regular intervals for the timeline visualization
@@ -40,6 +82,28 @@ public:
                           ProgressCallback progressCb = nullptr,
                           SampleCallback sampleCb = nullptr);
 
+    // Score `frames` (ascending) as the graph pass did with `params`, on the
+    // same input (the proxy if the graph came from it), to refine the curve
+    // where the timeline is zoomed in. Decodes in order on its own handle,
+    // reusing and filling the luma cache and yielding to interactive work.
+    // `visit` gets each sample and returns false to stop. Must not run
+    // while a pass does.
+    using RefineVisitor = std::function<bool(const FrameData& sample)>;
+    bool scoreFrames(const AnalysisParams& params, const std::vector<int>& frames,
+                     const RefineVisitor& visit);
+
+    // Sharpest frame within `windowSec` of `timeSec` (the shown frame for a
+    // zero window), scored on the original like the selection pass and
+    // returned selected with its thumbnail. `known` maps frames to scores
+    // already computed that way; the rest of the window is decoded in order
+    // on `decoder` (a handle on the original) through the luma cache.
+    bool findSharpestNear(FrameSource& decoder, const AnalysisParams& params, double timeSec,
+                          double windowSec, const std::unordered_map<int, double>& known,
+                          FrameData& out);
+
+    // Whether the last graph pass scored the proxy rather than the original
+    bool isGraphFromProxy() const { return graphFromProxy_; }
+
     // Find optimal frames using the search window algorithm
     bool findOptimalFrames(const AnalysisParams& params,
                            const std::vector<FrameData>& allSamples,
@@ -50,17 +114,116 @@ public:
     // Export selected frames to disk
     bool exportFrames(const std::vector<FrameData>& frames,
                       const std::string& outputDir,
+                      ExportFormat format = ExportFormat::JPEG,
                       ProgressCallback progressCb = nullptr);
 
+    // Codec side data read for the prefilter (empty until a pass needed it)
+    const CodecSideData& getCodecSideData() const { return sideData_; }
+
+    // Decoded scoring luma kept across analyses of the open video
+    LumaCache::Stats getLumaCacheStats() const { return lumaCache_.getStats(); }
+    // Reduction the open video is scored at for a requested `reduction`.
+    // Frames whose luma would exceed LumaCache::kMaxFramePixels are scored
+    // at the coarser power of two that fits, so reruns can use the cache.
+    int scoringReductionFor(int reduction) const;
+
+    // Decoding rate of the current (or last) analysis or export pass,
+    // counting time spent throttled by AnalysisParams::cpuCapPercent.
+    // getTotalThroughput() adds up every pass since the video was opened
+    // (the cap is the latest pass's).
+    struct Throughput {
+        int64_t frames = 0;
+        double seconds = 0.0;
+        int cpuCapPercent = 100;
+
+        double framesPerSec() const { return seconds > 0.0 ? frames / seconds : 0.0; }
+    };
+    Throughput getThroughput() const;
+    Throughput getTotalThroughput() const;
+
+    // Interactive consumers hold a ticket while decoding; passes, the proxy
+    // builder and other background work yield to them between frames
+    InteractiveGate& interactiveGate() { return gate_; }
+
+    // Called with each pass's decode schedule before it starts
+    void setPlanCallback(PlanCallback cb) { planCb_ = std::move(cb); }
+
     // Cancel ongoing operation
     void cancel() { cancelled_.store(true); }
     void resetCancel() { cancelled_.store(false); }
     bool isCancelled() const { return cancelled_.load(); }
 
 private:
-    cv::VideoCapture cap_;
+    // Schedule the given frames using the measured decode costs of the input
+    // `variant` (measured on `source` the first time)
+    DecodePlan planFrames(const FrameSource& source, int variant, const std::vector<int>& frames);
+
+    // Pass-local clone of `from` (the input by default), so a pass can set
+    // access hints and prefetch without touching sources other threads
+    // clone from. Null if closed or the clone fails.
+    std::unique_ptr<FrameSource> clonePassSource(const FrameSource* from = nullptr);
+
+    // Fold the last pass into the totals, reset the pass counters and set
+    // the worker CPU cap and priority for a new pass
+    void startPass(int cpuCapPercent, bool lowPriority);
+
+    // Read codec side data once per opened video; false if unavailable
+    bool ensureCodecSideData(const ProgressCallback& progressCb);
+
+    // Visit every planned frame with the source positioned on it. Runs are
+    // spread over OpenMP workers, each with its own source clone counted
+    // towards `use`; `visit` receives the frame's slot in plan.frames.
+    void runPlan(const FrameSource& source, DecoderUse use, const DecodePlan& plan,
+                 const std::function<void(FrameSource& source, size_t slot)>& visit);
+
+    // Visit the scoring luma of `frames` (sorted, unique) with its position in
+    // `frames`, possibly from several threads at once. Cached luma is used
+    // directly; the rest is decoded per plan and added to the cache. `variant`
+    // keeps luma from different inputs of the same video apart. Luma is read
+    // at the scoring reduction for `reduction` (see scoringReductionFor).
+    using LumaVisitor = std::function<void(size_t index, const cv::Mat& gray)>;
+    void visitLuma(FrameSource& source, int variant, const std::vector<int>& frames,
+                   int reduction, const LumaVisitor& visit);
+
+    // Scoring luma of `frame` from the cache, or else read from `decoder`,
+    // decoding forward to it within a GOP instead of seeking. Like
+    // visitLuma, reads at the scoring reduction for `reduction`.
+    bool readLumaForward(FrameSource& decoder, int variant, int frame, int reduction, cv::Mat& outGray);
+
+    static constexpr int kOriginalVariant = 0;
+    static constexpr int kProxyVariant = 1;
+
+    // The opened proxy, opening it once the builder has finished
+    std::shared_ptr<FrameSource> proxySource();
+
+    const std::shared_ptr<DecoderStats>& statsFor(DecoderUse use) const {
+        return decoderStats_[static_cast<size_t>(use)];
+    }
+
+    std::unique_ptr<FrameSource> source_;
     VideoInfo videoInfo_;
+    std::unordered_map<int, DecodeCosts> decodeCosts_;  // By input variant
+    PlanCallback planCb_;
+    CodecSideData sideData_;
+    bool sideDataProbed_ = false;
+    InteractiveGate gate_;
+    ProxyBuilder proxyBuilder_{&gate_};
+    std::atomic<bool> proxyBuilt_{false};
+    std::shared_ptr<FrameSource> proxy_;
+    bool graphFromProxy_ = false;  // Graph scores are at proxy resolution
+    LumaCache lumaCache_;
+    DecoderStatsArray decoderStats_;
     std::atomic<bool> cancelled_{false};
+
+    // Current pass
+    std::atomic<int> cpuCapPercent_{100};
+    std::atomic<bool> lowPriority_{false};
+    std::atomic<int64_t> passFrames_{0};
+    std::atomic<int64_t> passMicros_{0};      // Spent in finished runPlan calls
+    std::atomic<int64_t> runStartMicros_{0};  // Start of the running runPlan, 0 if none
+    std::atomic<int64_t> totalFrames_{0};     // Earlier passes of the open video
+    std::atomic<int64_t> totalMicros_{0};
+
     mutable std::recursive_mutex capMutex_;
 };
 
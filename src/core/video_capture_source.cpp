@@ -0,0 +1,172 @@
+#include "video_capture_source.hpp"
+#include <algorithm>
+
+namespace sharpctl {
+
+namespace {
+
+// Re-seek attempts when the backend lands past the target
+constexpr int kMaxSeekRetries = 3;
+
+}  // anonymous namespace
+
+VideoCaptureSource::~VideoCaptureSource() {
+    close();
+}
+
+bool VideoCaptureSource::openCapture(const std::string& path) {
+    cap_.open(path);
+    if (!cap_.isOpened()) {
+        return false;
+    }
+
+    info_.path = path;
+    info_.fps = cap_.get(cv::CAP_PROP_FPS);
+    info_.frameCount = static_cast<int>(cap_.get(cv::CAP_PROP_FRAME_COUNT));
+    info_.width = static_cast<int>(cap_.get(cv::CAP_PROP_FRAME_WIDTH));
+    info_.height = static_cast<int>(cap_.get(cv::CAP_PROP_FRAME_HEIGHT));
+
+    if (info_.fps > 0.0 && info_.frameCount > 0) {
+        info_.duration = info_.frameCount / info_.fps;
+    } else {
+        info_.duration = 0.0;
+    }
+
+    position_ = 0;
+    grabbed_ = false;
+    return true;
+}
+
+bool VideoCaptureSource::open(const std::string& path) {
+    close();
+
+    if (!openCapture(path)) {
+        return false;
+    }
+
+    // CAP_PROP_FRAME_COUNT and fps-derived durations are estimates on VFR footage
+    auto index = std::make_shared<FrameIndex>();
+    if (index->loadOrBuild(path)) {
+        info_.frameCount = index->frameCount();
+        info_.duration = index->duration();
+        index_ = std::move(index);
+    }
+    return true;
+}
+
+void VideoCaptureSource::close() {
+    if (cap_.isOpened()) {
+        cap_.release();
+    }
+    index_.reset();
+    info_ = VideoInfo{};
+    position_ = 0;
+    grabbed_ = false;
+}
+
+std::unique_ptr<FrameSource> VideoCaptureSource::clone() const {
+    auto copy = std::make_unique<VideoCaptureSource>();
+    if (!info_.path.empty() && copy->openCapture(info_.path)) {
+        copy->index_ = index_;
+        copy->info_ = info_;
+    }
+    return copy;
+}
+
+int VideoCaptureSource::frameAtTime(double timeSec) const {
+    if (index_) return index_->frameAtTime(timeSec);
+    return FrameSource::frameAtTime(timeSec);
+}
+
+double VideoCaptureSource::timeOfFrame(int index) const {
+    if (index_) return index_->timeOfFrame(index);
+    return FrameSource::timeOfFrame(index);
+}
+
+int VideoCaptureSource::keyframeAtOrBefore(int index) const {
+    if (index_) return index_->keyframeAtOrBefore(index);
+    return index;
+}
+
+std::vector<int> VideoCaptureSource::keyframes() const {
+    if (index_) return index_->keyframes();
+    return {};
+}
+
+bool VideoCaptureSource::skipFrame() {
+    if (grabbed_) {
+        grabbed_ = false;
+    } else if (!cap_.grab()) {
+        return false;
+    }
+    position_++;
+    return true;
+}
+
+bool VideoCaptureSource::seekToKeyframe(int keyframe, int target) {
+    double seekTime = index_->timeOfFrame(keyframe);
+
+    for (int attempt = 0; attempt < kMaxSeekRetries; ++attempt) {
+        if (!cap_.set(cv::CAP_PROP_POS_MSEC, seekTime * 1000.0) || !cap_.grab()) {
+            return false;
+        }
+
+        // The decoded timestamp tells where the backend actually landed
+        position_ = index_->frameAtTime(cap_.get(cv::CAP_PROP_POS_MSEC) / 1000.0);
+        grabbed_ = true;
+        if (position_ <= target) {
+            return true;
+        }
+
+        // Landed past the target (backends assume a constant frame rate); back off further
+        const int earlier = index_->keyframeAtOrBefore(std::max(0, keyframe - (position_ - target)));
+        seekTime = index_->timeOfFrame(earlier) - (attempt + 1) / std::max(info_.fps, 1.0);
+        keyframe = earlier;
+    }
+
+    // Last resort: decode from the start
+    if (!cap_.set(cv::CAP_PROP_POS_FRAMES, 0.0)) return false;
+    position_ = 0;
+    grabbed_ = false;
+    return true;
+}
+
+bool VideoCaptureSource::seekFrame(int index) {
+    if (!cap_.isOpened() || index < 0) return false;
+    if (index == position_) return true;
+
+    if (!index_) {
+        if (!cap_.set(cv::CAP_PROP_POS_FRAMES, static_cast<double>(index))) {
+            return false;
+        }
+        position_ = index;
+        grabbed_ = false;
+        return true;
+    }
+
+    bool needsSeek = false;
+    index_->framesToDecode(position_, index, &needsSeek);
+    if (needsSeek && !seekToKeyframe(index_->keyframeAtOrBefore(index), index)) {
+        return false;
+    }
+
+    // Decode forward to the target
+    while (position_ < index) {
+        if (!skipFrame()) return false;
+    }
+    return true;
+}
+
+bool VideoCaptureSource::readFrame(cv::Mat& outFrame) {
+    if (!cap_.isOpened()) return false;
+
+    const bool ok = grabbed_ ? cap_.retrieve(outFrame) : cap_.read(outFrame);
+    grabbed_ = false;
+    if (!ok) {
+        return false;
+    }
+    position_++;
+    return true;
+}
+
+}  // namespace sharpctl
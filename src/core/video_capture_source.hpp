@@ -0,0 +1,48 @@
+#pragma once
+
+#include "frame_source.hpp"
+#include "frame_index.hpp"
+
+namespace sharpctl {
+
+// Video file input through cv::VideoCapture. Frame count, duration and
+// time <-> frame mapping come from a FrameIndex (cached beside the video), and
+// seeks go to the keyframe at or before the target by timestamp before
+// decoding forward, so a frame index always yields the same picture.
+class VideoCaptureSource : public FrameSource {
+public:
+    VideoCaptureSource() = default;
+    ~VideoCaptureSource() override;
+
+    bool open(const std::string& path) override;
+    void close() override;
+    bool isOpen() const override { return cap_.isOpened(); }
+
+    const VideoInfo& getInfo() const override { return info_; }
+
+    std::unique_ptr<FrameSource> clone() const override;
+
+    bool seekFrame(int index) override;
+    int getPosition() const override { return position_; }
+    bool readFrame(cv::Mat& outFrame) override;
+    bool skipFrame() override;
+
+    int frameAtTime(double timeSec) const override;
+    double timeOfFrame(int index) const override;
+    int keyframeAtOrBefore(int index) const override;
+    std::vector<int> keyframes() const override;
+
+    const FrameIndex* getFrameIndex() const { return index_.get(); }
+
+private:
+    bool openCapture(const std::string& path);
+    bool seekToKeyframe(int keyframe, int target);
+
+    cv::VideoCapture cap_;
+    std::shared_ptr<const FrameIndex> index_;  // Shared with clones
+    VideoInfo info_;
+    int position_ = 0;     // Index of the next frame readFrame() returns
+    bool grabbed_ = false; // Frame at position_ is already decoded, awaiting retrieve()
+};
+
+}  // namespace sharpctl
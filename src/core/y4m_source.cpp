@@ -0,0 +1,379 @@
+#include "y4m_source.hpp"
+#include <filesystem>
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <regex>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace sharpctl {
+
+namespace {
+
+constexpr char kStreamMagic[] = "YUV4MPEG2 ";
+constexpr char kFrameMagic[] = "FRAME";
+
+// Plane geometry of one frame
+struct PlaneLayout {
+    int width = 0;
+    int height = 0;
+    int chromaWidth = 0;   // 0 for monochrome
+    int chromaHeight = 0;
+    int bitDepth = 8;      // Samples above 8 bits are stored as 16-bit little-endian words
+
+    int bytesPerSample() const { return bitDepth > 8 ? 2 : 1; }
+    int sampleType() const { return bitDepth > 8 ? CV_16UC1 : CV_8UC1; }
+    size_t lumaBytes() const { return static_cast<size_t>(width) * height * bytesPerSample(); }
+    size_t chromaBytes() const {
+        return static_cast<size_t>(chromaWidth) * chromaHeight * bytesPerSample();
+    }
+    size_t frameBytes() const { return lumaBytes() + 2 * chromaBytes(); }
+};
+
+// Parse a Y4M colorspace tag: 420jpeg, 420paldv, 422, 444, mono, 420p10, 444p12, mono16, ...
+bool setColorspace(PlaneLayout& layout, const std::string& colorspace) {
+    const int w = layout.width;
+    const int h = layout.height;
+
+    std::string base = colorspace;
+    int bits = 8;
+    if (colorspace.rfind("mono", 0) == 0) {
+        base = "mono";
+        if (colorspace.size() > 4) bits = std::atoi(colorspace.c_str() + 4);
+    } else {
+        const size_t p = colorspace.find('p');
+        if (p != std::string::npos && p + 1 < colorspace.size() &&
+            std::isdigit(static_cast<unsigned char>(colorspace[p + 1]))) {
+            base = colorspace.substr(0, p);
+            bits = std::atoi(colorspace.c_str() + p + 1);
+        }
+    }
+    if (bits < 8 || bits > 16) return false;
+    layout.bitDepth = bits;
+
+    if (base.rfind("420", 0) == 0) {
+        // 420, 420jpeg, 420paldv, 420mpeg2, 420p10
+        layout.chromaWidth = (w + 1) / 2;
+        layout.chromaHeight = (h + 1) / 2;
+    } else if (base == "422") {
+        layout.chromaWidth = (w + 1) / 2;
+        layout.chromaHeight = h;
+    } else if (base == "444") {
+        layout.chromaWidth = w;
+        layout.chromaHeight = h;
+    } else if (base == "mono") {
+        layout.chromaWidth = 0;
+        layout.chromaHeight = 0;
+    } else {
+        // Alpha variants (444alpha) are not supported
+        return false;
+    }
+    return true;
+}
+
+// Limited-range YCbCr -> 16-bit BGR for high bit depth frames (BT.2020 matrix,
+// which is what 10/12-bit HDR masters carry)
+void convertHighDepthToBgr(const cv::Mat& luma, const cv::Mat& cb, const cv::Mat& cr,
+                           int bitDepth, cv::Mat& outFrame) {
+    const float scale = static_cast<float>(1 << (bitDepth - 8));
+    const float yOffset = 16.0f * scale, yRange = 219.0f * scale;
+    const float cOffset = 128.0f * scale, cRange = 224.0f * scale;
+
+    outFrame.create(luma.rows, luma.cols, CV_16UC3);
+    for (int r = 0; r < luma.rows; ++r) {
+        const ushort* yRow = luma.ptr<ushort>(r);
+        const ushort* cbRow = cb.ptr<ushort>(r);
+        const ushort* crRow = cr.ptr<ushort>(r);
+        ushort* out = outFrame.ptr<ushort>(r);
+        for (int c = 0; c < luma.cols; ++c) {
+            const float y = (yRow[c] - yOffset) / yRange;
+            const float u = (cbRow[c] - cOffset) / cRange;
+            const float v = (crRow[c] - cOffset) / cRange;
+            const float rgb[3] = {
+                y + 1.8814f * u,                  // B
+                y - 0.16455f * u - 0.57135f * v,  // G
+                y + 1.4746f * v                   // R
+            };
+            for (int ch = 0; ch < 3; ++ch) {
+                const float value = std::clamp(rgb[ch], 0.0f, 1.0f) * 65535.0f;
+                out[c * 3 + ch] = static_cast<ushort>(value + 0.5f);
+            }
+        }
+    }
+}
+
+std::string lowerExtension(const std::string& path) {
+    std::string ext = fs::path(path).extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return ext;
+}
+
+size_t alignDown(size_t value, size_t alignment) {
+    return value - value % alignment;
+}
+
+}  // anonymous namespace
+
+// Read-only file mapping and frame table, shared by all clones
+struct Y4mSource::Mapping {
+    int fd = -1;
+    uchar* data = nullptr;
+    size_t size = 0;
+    PlaneLayout layout;
+    std::vector<size_t> frameOffsets;  // Offset of each frame's Y plane
+
+    ~Mapping() {
+        if (data) {
+            munmap(data, size);
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    // Parse the stream header and walk the FRAME markers (one touch per frame)
+    bool indexY4m(double& fps) {
+        const char* begin = reinterpret_cast<const char*>(data);
+        const size_t magicLen = sizeof(kStreamMagic) - 1;
+        if (size < magicLen || std::memcmp(begin, kStreamMagic, magicLen) != 0) return false;
+
+        const void* eol = std::memchr(begin, '\n', size);
+        if (!eol) return false;
+        const size_t headerEnd = static_cast<const char*>(eol) - begin + 1;
+
+        std::istringstream header(std::string(begin + magicLen, headerEnd - magicLen - 1));
+        std::string token;
+        std::string colorspace = "420jpeg";
+        fps = 0.0;
+        while (header >> token) {
+            switch (token[0]) {
+                case 'W': layout.width = std::atoi(token.c_str() + 1); break;
+                case 'H': layout.height = std::atoi(token.c_str() + 1); break;
+                case 'C': colorspace = token.substr(1); break;
+                case 'F': {
+                    int num = 0, den = 0;
+                    if (std::sscanf(token.c_str() + 1, "%d:%d", &num, &den) == 2 && den > 0) {
+                        fps = static_cast<double>(num) / den;
+                    }
+                    break;
+                }
+                default: break;
+            }
+        }
+        if (layout.width <= 0 || layout.height <= 0 || !setColorspace(layout, colorspace)) return false;
+
+        const size_t frameBytes = layout.frameBytes();
+        const size_t frameMagicLen = sizeof(kFrameMagic) - 1;
+        size_t pos = headerEnd;
+        while (pos + frameMagicLen <= size &&
+               std::memcmp(begin + pos, kFrameMagic, frameMagicLen) == 0) {
+            // Frame headers may carry parameters, so find the end of line
+            const void* frameEol = std::memchr(begin + pos, '\n', size - pos);
+            if (!frameEol) break;
+            const size_t dataStart = static_cast<const char*>(frameEol) - begin + 1;
+            if (dataStart + frameBytes > size) break;  // Truncated last frame
+
+            frameOffsets.push_back(dataStart);
+            pos = dataStart + frameBytes;
+        }
+        return !frameOffsets.empty();
+    }
+
+    // Headerless 4:2:0, size taken from the file name
+    bool indexRawYuv(const std::string& path) {
+        static const std::regex sizePattern("(\\d+)x(\\d+)");
+        const std::string name = fs::path(path).stem().string();
+        std::smatch match;
+        if (!std::regex_search(name, match, sizePattern)) return false;
+
+        layout.width = std::stoi(match[1].str());
+        layout.height = std::stoi(match[2].str());
+        if (layout.width <= 0 || layout.height <= 0 || !setColorspace(layout, "420")) return false;
+
+        const size_t frameBytes = layout.frameBytes();
+        for (size_t offset = 0; offset + frameBytes <= size; offset += frameBytes) {
+            frameOffsets.push_back(offset);
+        }
+        return !frameOffsets.empty();
+    }
+};
+
+Y4mSource::~Y4mSource() {
+    close();
+}
+
+bool Y4mSource::isRawVideoFile(const std::string& path) {
+    const std::string ext = lowerExtension(path);
+    return ext == ".y4m" || ext == ".yuv";
+}
+
+bool Y4mSource::open(const std::string& path) {
+    close();
+
+    auto mapping = std::make_shared<Mapping>();
+    mapping->fd = ::open(path.c_str(), O_RDONLY);
+    if (mapping->fd < 0) return false;
+
+    struct stat st {};
+    if (fstat(mapping->fd, &st) != 0 || st.st_size <= 0) return false;
+    mapping->size = static_cast<size_t>(st.st_size);
+
+    void* data = mmap(nullptr, mapping->size, PROT_READ, MAP_SHARED, mapping->fd, 0);
+    if (data == MAP_FAILED) return false;
+    mapping->data = static_cast<uchar*>(data);
+
+    double fps = 0.0;
+    const bool indexed = lowerExtension(path) == ".y4m" ? mapping->indexY4m(fps)
+                                                        : mapping->indexRawYuv(path);
+    if (!indexed) return false;
+
+    info_.path = path;
+    info_.fps = fps > 0.0 ? fps : kRawYuvFps;
+    info_.frameCount = static_cast<int>(mapping->frameOffsets.size());
+    info_.width = mapping->layout.width;
+    info_.height = mapping->layout.height;
+    info_.bitDepth = mapping->layout.bitDepth;
+    info_.duration = info_.frameCount / info_.fps;
+
+    mapping_ = std::move(mapping);
+    position_ = 0;
+    return true;
+}
+
+void Y4mSource::close() {
+    mapping_.reset();
+    info_ = VideoInfo{};
+    position_ = 0;
+}
+
+std::unique_ptr<FrameSource> Y4mSource::clone() const {
+    auto copy = std::make_unique<Y4mSource>();
+    copy->mapping_ = mapping_;
+    copy->info_ = info_;
+    copy->pattern_ = pattern_;
+    return copy;
+}
+
+bool Y4mSource::seekFrame(int index) {
+    if (!mapping_ || index < 0 || index >= info_.frameCount) return false;
+    position_ = index;
+    return true;
+}
+
+const uchar* Y4mSource::framePtr(int index) const {
+    return mapping_->data + mapping_->frameOffsets[index];
+}
+
+void Y4mSource::setAccessPattern(AccessPattern pattern) {
+    if (!mapping_) return;
+    pattern_ = pattern;
+
+    int advice = MADV_NORMAL;
+    if (pattern == AccessPattern::Sequential) advice = MADV_SEQUENTIAL;
+    if (pattern == AccessPattern::Random) advice = MADV_RANDOM;
+    madvise(mapping_->data, mapping_->size, advice);
+}
+
+void Y4mSource::adviseAhead(int index) const {
+    // Kernel read-ahead does not cross into the next frame under MADV_RANDOM,
+    // so sequential readers ask for the next frame explicitly
+    if (pattern_ != AccessPattern::Sequential || index + 1 >= info_.frameCount) return;
+
+    static const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t start = alignDown(mapping_->frameOffsets[index + 1], pageSize);
+    const size_t length = std::min(mapping_->layout.frameBytes() + pageSize, mapping_->size - start);
+    madvise(mapping_->data + start, length, MADV_WILLNEED);
+}
+
+bool Y4mSource::readLuma(cv::Mat& outGray, int reduction) {
+    if (!mapping_ || position_ < 0 || position_ >= info_.frameCount) return false;
+
+    const int index = position_++;
+    adviseAhead(index);
+
+    // Zero-copy header over the mapped Y plane (the mapping is read-only).
+    // High bit depth planes come out as CV_16U without any conversion.
+    const PlaneLayout& layout = mapping_->layout;
+    cv::Mat luma(layout.height, layout.width, layout.sampleType(), const_cast<uchar*>(framePtr(index)));
+    if (reduction > 1) {
+        toLuma(luma, outGray, reduction);
+    } else {
+        outGray = luma;
+    }
+    return true;
+}
+
+bool Y4mSource::readFrame(cv::Mat& outFrame) {
+    if (!mapping_ || position_ < 0 || position_ >= info_.frameCount) return false;
+
+    const int index = position_++;
+    adviseAhead(index);
+
+    const PlaneLayout& layout = mapping_->layout;
+    uchar* data = const_cast<uchar*>(framePtr(index));
+    cv::Mat luma(layout.height, layout.width, layout.sampleType(), data);
+
+    if (layout.bitDepth > 8) {
+        // Keep full precision: 16-bit BGR scaled to the full 16-bit range
+        if (layout.chromaWidth == 0) {
+            cv::Mat scaled;
+            luma.convertTo(scaled, CV_16U, 65535.0 / ((1 << layout.bitDepth) - 1));
+            cv::cvtColor(scaled, outFrame, cv::COLOR_GRAY2BGR);
+            return true;
+        }
+
+        cv::Mat chroma[2];
+        for (int plane = 0; plane < 2; ++plane) {
+            cv::Mat sub(layout.chromaHeight, layout.chromaWidth, CV_16UC1,
+                        data + layout.lumaBytes() + plane * layout.chromaBytes());
+            cv::resize(sub, chroma[plane], luma.size(), 0, 0, cv::INTER_LINEAR);
+        }
+        convertHighDepthToBgr(luma, chroma[0], chroma[1], layout.bitDepth, outFrame);
+        return true;
+    }
+
+    if (layout.chromaWidth == 0) {
+        cv::cvtColor(luma, outFrame, cv::COLOR_GRAY2BGR);
+        return true;
+    }
+
+    const bool is420 = layout.chromaWidth == layout.width / 2 &&
+                       layout.chromaHeight == layout.height / 2;
+    if (is420 && layout.width % 2 == 0 && layout.height % 2 == 0) {
+        // Planes are contiguous in I420 order
+        cv::Mat yuv(layout.height * 3 / 2, layout.width, CV_8UC1, data);
+        cv::cvtColor(yuv, outFrame, cv::COLOR_YUV2BGR_I420);
+        return true;
+    }
+
+    // 4:2:2 / 4:4:4 (or odd sizes): resample chroma into an I420 buffer
+    const int evenW = layout.width & ~1;
+    const int evenH = layout.height & ~1;
+    cv::Mat i420(evenH * 3 / 2, evenW, CV_8UC1);
+    cv::Mat i420Luma = i420(cv::Rect(0, 0, evenW, evenH));
+    luma(cv::Rect(0, 0, evenW, evenH)).copyTo(i420Luma);
+
+    const size_t chromaBytes = layout.chromaBytes();
+    const cv::Size halfSize(evenW / 2, evenH / 2);
+    for (int plane = 0; plane < 2; ++plane) {
+        cv::Mat chroma(layout.chromaHeight, layout.chromaWidth, CV_8UC1,
+                       data + layout.lumaBytes() + plane * chromaBytes);
+        cv::Mat dst(halfSize.height, halfSize.width, CV_8UC1,
+                    i420.data + static_cast<size_t>(evenW) * evenH +
+                    plane * static_cast<size_t>(halfSize.area()));
+        cv::resize(chroma, dst, halfSize, 0, 0, cv::INTER_AREA);
+    }
+    cv::cvtColor(i420, outFrame, cv::COLOR_YUV2BGR_I420);
+    return true;
+}
+
+}  // namespace sharpctl
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "frame_source.hpp"
+
+namespace sharpctl {
+
+// Uncompressed YUV4MPEG2 (.y4m) or headerless planar 4:2:0 (.yuv) input.
+// The file is memory-mapped; readLuma() returns a cv::Mat header pointing
+// straight into the mapping (read-only, valid while the source is open),
+// so scoring runs from the page cache without copies or color conversion.
+// Headerless .yuv files need the size in the name, e.g. "clip_1920x1080.yuv".
+class Y4mSource : public FrameSource {
+public:
+    static constexpr double kRawYuvFps = 25.0;
+
+    Y4mSource() = default;
+    ~Y4mSource() override;
+
+    bool open(const std::string& path) override;
+    void close() override;
+    bool isOpen() const override { return mapping_ != nullptr; }
+
+    const VideoInfo& getInfo() const override { return info_; }
+
+    std::unique_ptr<FrameSource> clone() const override;
+
+    bool seekFrame(int index) override;
+    int getPosition() const override { return position_; }
+    bool readFrame(cv::Mat& outFrame) override;
+    bool readLuma(cv::Mat& outGray, int reduction = 1) override;
+
+    void setAccessPattern(AccessPattern pattern) override;
+
+    // Check whether a path has a .y4m or .yuv extension
+    static bool isRawVideoFile(const std::string& path);
+
+private:
+    struct Mapping;
+
+    const uchar* framePtr(int index) const;
+    void adviseAhead(int index) const;
+
+    std::shared_ptr<Mapping> mapping_;
+    VideoInfo info_;
+    int position_ = 0;
+    AccessPattern pattern_ = AccessPattern::Normal;
+};
+
+}  // namespace sharpctl
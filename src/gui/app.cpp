@@ -2,6 +2,8 @@
 #include "panels/control_panel.hpp"
 #include "panels/timeline_panel.hpp"
 #include "panels/preview_panel.hpp"
+#include "panels/filmstrip_panel.hpp"
+#include "core/frame_pool.hpp"
 
 #include <imgui.h>
 #include <imgui_impl_sdl2.h>
@@ -12,9 +14,32 @@
 #include <iostream>
 #include <filesystem>
 #include <fstream>
+#include <algorithm>
+#include <functional>
+#include <iterator>
 
 namespace sharpctl {
 
+namespace {
+
+// Shortest time between live sample publishes while a pass is running
+constexpr std::chrono::steady_clock::duration kMinPublishInterval = std::chrono::milliseconds(100);
+
+constexpr int kIdleWaitMs = 1000;  // Longest sleep of an idle render loop
+constexpr int kSettleFrames = 3;   // Frames rendered after each event
+constexpr std::chrono::milliseconds kStatsInterval{250};
+
+// Published samples and selections are kept in time order, so panels can
+// look frames up by binary search (findNearestByTime)
+void sortByTime(std::vector<FrameData>& frames) {
+    auto byTime = [](const FrameData& a, const FrameData& b) { return a.time < b.time; };
+    if (!std::is_sorted(frames.begin(), frames.end(), byTime)) {
+        std::stable_sort(frames.begin(), frames.end(), byTime);
+    }
+}
+
+}  // anonymous namespace
+
 App::App() = default;
 
 App::~App() {
@@ -76,6 +101,64 @@ bool App::init() {
     ImGui_ImplSDL2_InitForOpenGL(window_, glContext_);
     ImGui_ImplOpenGL3_Init("#version 330");
 
+    // Each pass's decode schedule is shown in the Performance section
+    analyzer_.setPlanCallback([this](const DecodePlan& plan, int threads) {
+        std::lock_guard<std::mutex> lock(perfMutex_);
+        decodePlan_ = plan.summary(threads);
+    });
+
+    // Wake-up event for the idle render loop
+    wakeEventType_ = SDL_RegisterEvents(1);
+
+    // Hover previews and thumbnails are decoded off the UI thread
+    previewWorker_.start([this](cv::Mat& frame, double, bool exact) { setPreviewFrame(frame, exact); });
+    thumbnailWorker_.start([this]() { requestRedraw(); });
+
+    // Frames added by hand are searched for in the background, then
+    // inserted in time order (or reselected if already listed)
+    snapWorker_.start([this](FrameData& frame) {
+        selectedFrames_.update([&](std::vector<FrameData>& frames) {
+            auto it = std::lower_bound(frames.begin(), frames.end(), frame,
+                [](const FrameData& a, const FrameData& b) { return a.time < b.time; });
+            auto same = std::find_if(frames.begin(), frames.end(),
+                [&](const FrameData& f) { return f.frameIndex == frame.frameIndex; });
+            if (same != frames.end()) {
+                same->selected = true;
+            } else {
+                frames.insert(it, std::move(frame));
+            }
+        });
+        configDirty_ = true;
+        requestRedraw();
+    });
+
+    // Zoomed-in parts of the curve are refined in the background
+    refineWorker_.start([this](std::vector<FrameData>& refined) {
+        auto byTime = [](const FrameData& a, const FrameData& b) { return a.time < b.time; };
+        allSamples_.update([&](std::vector<FrameData>& samples) {
+            std::vector<FrameData> merged;
+            merged.reserve(samples.size() + refined.size());
+            std::merge(std::make_move_iterator(samples.begin()), std::make_move_iterator(samples.end()),
+                       std::make_move_iterator(refined.begin()), std::make_move_iterator(refined.end()),
+                       std::back_inserter(merged), byTime);
+            merged.erase(std::unique(merged.begin(), merged.end(),
+                                     [](const FrameData& a, const FrameData& b) {
+                                         return a.frameIndex == b.frameIndex;
+                                     }),
+                         merged.end());
+            samples.swap(merged);
+        });
+        requestRedraw();
+    });
+
+    // System stats are sampled on their own timer
+    statsStopping_ = false;
+    statsThread_ = std::thread([this]() { runStatsThread(); });
+
+    // Videos are opened and configs parsed off the UI thread
+    loadStopping_ = false;
+    loadThread_ = std::thread([this]() { runLoadThread(); });
+
     return true;
 }
 
@@ -235,14 +318,38 @@ void App::run() {
     bool running = true;
 
     while (running) {
-        handleEvents(running);
+        // Render continuously while something is in motion, else sleep until woken
+        const bool active = isAnalyzing() || analyzer_.isBuildingProxy() || activeFrames_ > 0;
+        handleEvents(running, active ? 0 : kIdleWaitMs);
         renderFrame();
+        if (activeFrames_ > 0) {
+            activeFrames_--;
+        }
+    }
+}
+
+void App::requestRedraw() {
+    // One pending wake-up is enough
+    if (wakeEventType_ == 0 || wakeEventType_ == static_cast<Uint32>(-1) || wakePending_.exchange(true)) return;
+
+    SDL_Event event{};
+    event.type = wakeEventType_;
+    if (SDL_PushEvent(&event) <= 0) {
+        wakePending_.store(false);
     }
 }
 
-void App::handleEvents(bool& running) {
+void App::handleEvents(bool& running, int waitMs) {
     SDL_Event event;
-    while (SDL_PollEvent(&event)) {
+    int pending = waitMs > 0 ? SDL_WaitEventTimeout(&event, waitMs) : SDL_PollEvent(&event);
+    for (; pending; pending = SDL_PollEvent(&event)) {
+        // A wake-up needs one frame; input may need a few for ImGui to settle
+        if (event.type == wakeEventType_) {
+            wakePending_.store(false);
+            continue;
+        }
+        activeFrames_ = kSettleFrames;
+
         ImGui_ImplSDL2_ProcessEvent(&event);
 
         if (event.type == SDL_QUIT) {
@@ -274,8 +381,6 @@ void App::handleEvents(bool& running) {
 }
 
 void App::renderFrame() {
-    updatePerfStats();
-
     ImGui_ImplOpenGL3_NewFrame();
     ImGui_ImplSDL2_NewFrame();
     ImGui::NewFrame();
@@ -307,10 +412,14 @@ void App::renderFrame() {
 
     ImGui::End();
 
+    applyLoaded();
+
     // Render panels
+    perfVisible_.store(false);
     gui::renderControlPanel(*this);
     gui::renderPreviewPanel(*this);
     gui::renderTimelinePanel(*this);
+    gui::renderFilmstripPanel(*this);
 
     // Rendering
     ImGui::Render();
@@ -323,6 +432,29 @@ void App::renderFrame() {
 }
 
 void App::shutdown() {
+    // An open in progress cannot be interrupted; wait for it
+    {
+        std::lock_guard<std::mutex> lock(loadMutex_);
+        loadStopping_ = true;
+    }
+    loadWake_.notify_all();
+    if (loadThread_.joinable()) {
+        loadThread_.join();
+    }
+
+    previewWorker_.stop();
+    thumbnailWorker_.stop();
+    refineWorker_.stop();
+    snapWorker_.stop();
+    {
+        std::lock_guard<std::mutex> lock(perfMutex_);
+        statsStopping_ = true;
+    }
+    statsWake_.notify_all();
+    if (statsThread_.joinable()) {
+        statsThread_.join();
+    }
+
     // Wait for analysis thread
     if (analysisThread_.joinable()) {
         cancelAnalysis();
@@ -353,77 +485,166 @@ void App::loadVideo(const std::string& path) {
         }
     }
 
+    // Refinement and snapping work on the old video; stop them before its
+    // samples and selection are cleared, or a late snap lands in the new one
+    refineWorker_.reset();
+    snapWorker_.reset();
+    lastRefinement_ = {};
+    curveParams_ = params_;
+
+    // Hand the path to the loader; anything still in flight for an earlier
+    // load is discarded by the generation check
     {
-        std::lock_guard<std::mutex> lock(samplesMutex_);
-        allSamples_.clear();
+        std::lock_guard<std::mutex> lock(loadMutex_);
+        loadPath_ = path;
+        loadParams_ = params_;
+        loadGeneration_++;
+        loadedInfo_.reset();
+        loadedParams_.reset();
+        allSamples_.publish({});
+        selectedFrames_.publish({});
+        loading_.store(true);
     }
-    selectedFrames_.clear();
+    loadWake_.notify_one();
+
     progress_.store(0.0f);
+    previewWorker_.reset();
+    thumbnailWorker_.reset();
+    videoInfo_ = VideoInfo{};
+    configDirty_ = false;
+    {
+        std::lock_guard<std::mutex> lock(statusMutex_);
+        statusText_ = "Opening: " + path;
+    }
+}
 
-    if (analyzer_.openVideo(path)) {
-        videoInfo_ = analyzer_.getVideoInfo();
-        configDirty_ = false;
+void App::runLoadThread() {
+    while (true) {
+        std::string path;
+        AnalysisParams params;
+        uint64_t generation;
+        {
+            std::unique_lock<std::mutex> lock(loadMutex_);
+            loadWake_.wait(lock, [this]() { return loadStopping_ || !loadPath_.empty(); });
+            if (loadStopping_) break;
+            path.swap(loadPath_);
+            params = loadParams_;
+            generation = loadGeneration_;
+        }
 
-        // Try to load existing config
-        if (loadConfig()) {
-            std::lock_guard<std::mutex> lock(statusMutex_);
-            statusText_ = "Video loaded with config: " + videoInfo_.path;
-        } else {
-            std::lock_guard<std::mutex> lock(statusMutex_);
-            statusText_ = "Video loaded: " + videoInfo_.path;
+        // Metadata first, so the panels can lay out the video
+        const bool opened = analyzer_.openVideo(path);
+        {
+            std::lock_guard<std::mutex> lock(loadMutex_);
+            if (generation != loadGeneration_) continue;
+            loadedInfo_ = opened ? analyzer_.getVideoInfo() : VideoInfo{};
         }
-    } else {
-        videoInfo_ = VideoInfo{};
+        requestRedraw();
+
+        const bool hasConfig = opened && loadConfig(generation, params);
+        if (opened && params.useProxy) {
+            analyzer_.startProxy();
+        }
+
         {
-            std::lock_guard<std::mutex> lock(statusMutex_);
-            statusText_ = "Failed to load video";
+            std::lock_guard<std::mutex> lock(loadMutex_);
+            if (generation != loadGeneration_) continue;
+            loading_.store(false);
+
+            std::lock_guard<std::mutex> statusLock(statusMutex_);
+            if (!opened) {
+                statusText_ = "Failed to load video";
+            } else if (hasConfig) {
+                statusText_ = "Video loaded with config: " + path;
+            } else {
+                statusText_ = "Video loaded: " + path;
+            }
+            if (opened && !analyzer_.hasKeyframes() && !std::filesystem::is_directory(path)) {
+                statusText_ += " (no keyframe flags: keyframe scan and scrub proxy unavailable)";
+            }
         }
+        requestRedraw();
+    }
+}
+
+void App::applyLoaded() {
+    std::lock_guard<std::mutex> lock(loadMutex_);
+    if (loadedInfo_) {
+        videoInfo_ = *loadedInfo_;
+        loadedInfo_.reset();
+    }
+    if (loadedParams_) {
+        params_ = *loadedParams_;
+        curveParams_ = params_;
+        loadedParams_.reset();
+        configDirty_ = false;
     }
 }
 
 void App::startAnalysis() {
-    if (isAnalyzing() || !analyzer_.isOpen()) return;
+    if (isAnalyzing() || isLoading() || !analyzer_.isOpen()) return;
 
     if (analysisThread_.joinable()) {
         analysisThread_.join();
     }
 
-    // Clear samples before starting
-    {
-        std::lock_guard<std::mutex> lock(samplesMutex_);
-        allSamples_.clear();
-    }
-    selectedFrames_.clear();
+    // Clear samples before starting; refinement waits for the pass to end
+    refineWorker_.reset();
+    lastRefinement_ = {};
+    allSamples_.publish({});
+    selectedFrames_.publish({});
 
     analyzing_.store(true);
     progress_.store(0.0f);
     analysisStartTime_ = std::chrono::steady_clock::now();
     analyzer_.resetCancel();
 
-    analysisThread_ = std::thread([this]() {
+    // The pass runs on a copy, so edits meanwhile cannot tear it
+    AnalysisParams params = params_;
+    const bool background = backgroundMode_;
+    if (!background) {
+        params.cpuCapPercent = 100;
+    }
+    params.lowPriority = background;
+    curveParams_ = params;
+
+    analysisThread_ = std::thread([this, params, background]() {
+        // Work done on this thread itself (e.g. the side data probe) runs
+        // lowered too; pass workers lower themselves per pass
+        if (background && !lowerThreadPriority()) {
+            std::cerr << "Could not lower analysis priority" << std::endl;
+        }
+
         // First pass: analyze full video for graph
-        std::vector<FrameData> samples;
-        bool success = analyzer_.analyzeFullVideo(params_, samples,
+        std::vector<FrameData> samples, live;
+        auto lastPublish = std::chrono::steady_clock::now();
+        std::chrono::steady_clock::duration publishInterval = kMinPublishInterval;
+        bool success = analyzer_.analyzeFullVideo(params, samples,
             [this](float progress, const std::string& status) {
                 progress_.store(progress * 0.5f);  // 0-50%
                 std::lock_guard<std::mutex> lock(statusMutex_);
                 statusText_ = status;
             },
-            [this](const FrameData& sample) {
-                // Update allSamples_ in real-time for live graph updates
-                std::lock_guard<std::mutex> lock(samplesMutex_);
-                allSamples_.push_back(sample);
+            [&](const FrameData& sample) {
+                // Live graph updates. Every publish copies all samples so far,
+                // so the interval grows with the copy time to bound the cost.
+                live.push_back(sample);
+                const auto now = std::chrono::steady_clock::now();
+                if (now - lastPublish >= publishInterval) {
+                    allSamples_.publish(live);
+                    lastPublish = std::chrono::steady_clock::now();
+                    publishInterval = std::max<std::chrono::steady_clock::duration>(
+                        kMinPublishInterval, (lastPublish - now) * 10);
+                }
             });
 
         if (success && !analyzer_.isCancelled()) {
+            sortByTime(samples);
+            allSamples_.publish(samples);
+
             // Second pass: find optimal frames
-            std::vector<FrameData> localSamples;
-            {
-                std::lock_guard<std::mutex> lock(samplesMutex_);
-                localSamples = allSamples_;
-            }
             std::vector<FrameData> selected;
-            success = analyzer_.findOptimalFrames(params_, localSamples, selected,
+            success = analyzer_.findOptimalFrames(params, samples, selected,
                 [this](float progress, const std::string& status) {
                     progress_.store(0.5f + progress * 0.5f);  // 50-100%
                     std::lock_guard<std::mutex> lock(statusMutex_);
@@ -441,7 +662,8 @@ void App::startAnalysis() {
                 });
 
             if (success && !analyzer_.isCancelled()) {
-                selectedFrames_ = std::move(selected);
+                sortByTime(selected);
+                selectedFrames_.publish(std::move(selected));
                 configDirty_ = true;
             }
         }
@@ -449,12 +671,16 @@ void App::startAnalysis() {
         // Clear search state
         setSearchState(SearchState{});
 
+        // The pass's decode buffers are not needed until the next one
+        FramePool::instance().trim();
+
         analyzing_.store(false);
         progress_.store(1.0f);
         {
             std::lock_guard<std::mutex> lock(statusMutex_);
             statusText_ = analyzer_.isCancelled() ? "Analysis cancelled" : "Analysis complete";
         }
+        requestRedraw();
     });
 }
 
@@ -463,7 +689,8 @@ void App::cancelAnalysis() {
 }
 
 void App::exportFrames(const std::string& outputDir) {
-    if (isAnalyzing() || selectedFrames_.empty()) return;
+    FramesSnapshot frames = selectedFrames_.load();
+    if (isAnalyzing() || frames->value.empty()) return;
 
     if (analysisThread_.joinable()) {
         analysisThread_.join();
@@ -474,13 +701,14 @@ void App::exportFrames(const std::string& outputDir) {
     analysisStartTime_ = std::chrono::steady_clock::now();
     analyzer_.resetCancel();
 
-    analysisThread_ = std::thread([this, outputDir]() {
-        analyzer_.exportFrames(selectedFrames_, outputDir,
+    analysisThread_ = std::thread([this, outputDir, frames]() {
+        analyzer_.exportFrames(frames->value, outputDir, exportFormat_,
             [this](float progress, const std::string& status) {
                 progress_.store(progress);
                 std::lock_guard<std::mutex> lock(statusMutex_);
                 statusText_ = status;
             });
+        FramePool::instance().trim();
 
         analyzing_.store(false);
         progress_.store(1.0f);
@@ -488,6 +716,7 @@ void App::exportFrames(const std::string& outputDir) {
             std::lock_guard<std::mutex> lock(statusMutex_);
             statusText_ = analyzer_.isCancelled() ? "Export cancelled" : "Export complete";
         }
+        requestRedraw();
     });
 }
 
@@ -511,46 +740,100 @@ float App::getRemainingSeconds() const {
     return std::max(0.0f, remaining);
 }
 
-void App::toggleFrameSelection(int index) {
-    if (index >= 0 && index < static_cast<int>(selectedFrames_.size())) {
-        selectedFrames_[index].selected = !selectedFrames_[index].selected;
-        configDirty_ = true;
-    }
+void App::toggleFrameSelection(const FrameData& frame) {
+    // Looked up again here: a snapped frame may have been inserted since
+    // the caller's snapshot, shifting positions
+    selectedFrames_.update([&](std::vector<FrameData>& frames) {
+        auto it = std::find_if(frames.begin(), frames.end(), [&](const FrameData& f) {
+            return frame.frameIndex >= 0 ? f.frameIndex == frame.frameIndex : f.time == frame.time;
+        });
+        if (it != frames.end()) {
+            it->selected = !it->selected;
+            configDirty_ = true;
+        }
+    });
 }
 
 void App::addFrameAtTime(double time) {
-    if (!analyzer_.isOpen()) return;
-
-    cv::Mat frame;
-    if (analyzer_.getFrameAt(time, frame)) {
-        FrameData data;
-        data.time = time;
-        data.sharpness = VideoAnalyzer::calculateSharpness(frame, params_.algorithm);
-        data.selected = true;
-
-        // Create thumbnail
-        const int thumbHeight = 120;
-        const int thumbWidth = static_cast<int>(thumbHeight * frame.cols / frame.rows);
-        cv::resize(frame, data.thumbnail, cv::Size(thumbWidth, thumbHeight));
-
-        // Insert in sorted order
-        auto it = std::lower_bound(selectedFrames_.begin(), selectedFrames_.end(), data,
-            [](const FrameData& a, const FrameData& b) { return a.time < b.time; });
-        selectedFrames_.insert(it, data);
-        configDirty_ = true;
+    if (!analyzer_.isOpen() || isLoading()) return;
+
+    // Curve scores are reused when they were computed the way the search
+    // scores: same algorithm and scale, on the original
+    SnapWorker::Job job;
+    job.time = time;
+    job.params = params_;
+    const bool curveMatches = !isAnalyzing() && !analyzer_.isGraphFromProxy() &&
+                              curveParams_.algorithm == params_.algorithm &&
+                              curveParams_.decodeReduction == params_.decodeReduction;
+    if (curveMatches) {
+        const double window = params_.snapWindowSec;
+        const FramesSnapshot samples = allSamples_.load();
+        const std::vector<FrameData>& values = samples->value;
+        auto it = std::lower_bound(values.begin(), values.end(), time - window,
+                                   [](const FrameData& frame, double t) { return frame.time < t; });
+        for (; it != values.end() && it->time <= time + window; ++it) {
+            if (it->frameIndex >= 0) {
+                job.known[it->frameIndex] = it->sharpness;
+            }
+        }
+    }
+
+    snapWorker_.request(std::move(job));
+    requestRedraw();
+}
+
+void App::requestRefinement(double startSec, double endSec, int maxFrames) {
+    if (isAnalyzing() || isLoading() || !analyzer_.isOpen() || maxFrames <= 0) return;
+    {
+        // The parameters of a loaded curve are not applied yet
+        std::lock_guard<std::mutex> lock(loadMutex_);
+        if (loadedParams_) return;
+    }
+
+    // Only a curve that exists is refined
+    const FramesSnapshot samples = allSamples_.load();
+    const std::vector<FrameData>& have = samples->value;
+    if (have.empty()) return;
+
+    const int first = std::max(0, analyzer_.frameAtTime(startSec));
+    const int last = std::min(videoInfo_.frameCount - 1, analyzer_.frameAtTime(endSec));
+    if (last < first) return;
+
+    // Power-of-two steps on a grid aligned to them, so small pans and zooms
+    // mostly ask for frames that are already scored
+    int step = 1;
+    while (step < (last - first + 1) / maxFrames) {
+        step *= 2;
+    }
+    const int gridFirst = (first + step - 1) / step * step;
+
+    const std::array<int, 3> range{gridFirst, last, step};
+    if (range == lastRefinement_) return;
+    lastRefinement_ = range;
+
+    // Skip frames the curve already has; both lists are in frame order
+    auto it = std::lower_bound(have.begin(), have.end(), analyzer_.timeOfFrame(gridFirst),
+                               [](const FrameData& frame, double t) { return frame.time < t; });
+    std::vector<int> frames;
+    for (int frame = gridFirst; frame <= last; frame += step) {
+        while (it != have.end() && it->frameIndex < frame) ++it;
+        if (it == have.end() || it->frameIndex != frame) {
+            frames.push_back(frame);
+        }
     }
+    refineWorker_.request(curveParams_, std::move(frames));
 }
 
 int App::getSelectedCount() const {
     int count = 0;
-    for (const auto& f : selectedFrames_) {
+    for (const auto& f : selectedFrames_.load()->value) {
         if (f.selected) count++;
     }
     return count;
 }
 
 bool App::saveConfig() {
-    if (videoInfo_.path.empty()) return false;
+    if (videoInfo_.path.empty() || isLoading()) return false;
 
     std::string configPath = getConfigPath(videoInfo_.path);
     cv::FileStorage fs(configPath, cv::FileStorage::WRITE);
@@ -562,23 +845,27 @@ bool App::saveConfig() {
     fs << "interval_sec" << params_.intervalSec;
     fs << "search_window_sec" << params_.searchWindowSec;
     fs << "search_step_sec" << params_.searchStepSec;
+    fs << "snap_window_sec" << params_.snapWindowSec;
     fs << "sample_step_sec" << params_.sampleStepSec;
+    fs << "decode_reduction" << params_.decodeReduction;
+    fs << "scan_mode" << (params_.scanMode == ScanMode::Keyframes ? "Keyframes" : "Full");
+    fs << "codec_prefilter" << static_cast<int>(params_.codecPrefilter);
+    fs << "use_proxy" << static_cast<int>(params_.useProxy);
     fs << "algorithm" << (params_.algorithm == SharpnessAlgorithm::FFT ? "FFT" : "Laplacian");
     fs << "}";
 
     fs << "samples" << "[";
-    {
-        std::lock_guard<std::mutex> lock(samplesMutex_);
-        for (const auto& sample : allSamples_) {
-            fs << "{" << "time" << sample.time << "sharpness" << sample.sharpness << "}";
-        }
+    for (const auto& sample : allSamples_.load()->value) {
+        fs << "{" << "time" << sample.time << "frame" << sample.frameIndex
+           << "sharpness" << sample.sharpness << "motion" << sample.motion << "}";
     }
     fs << "]";
 
     fs << "selected_frames" << "[";
-    for (const auto& frame : selectedFrames_) {
+    for (const auto& frame : selectedFrames_.load()->value) {
         if (frame.selected) {
-            fs << "{" << "time" << frame.time << "sharpness" << frame.sharpness << "}";
+            fs << "{" << "time" << frame.time << "frame" << frame.frameIndex
+               << "sharpness" << frame.sharpness << "}";
         }
     }
     fs << "]";
@@ -594,10 +881,8 @@ bool App::saveConfig() {
     return true;
 }
 
-bool App::loadConfig() {
-    if (videoInfo_.path.empty()) return false;
-
-    std::string configPath = getConfigPath(videoInfo_.path);
+bool App::loadConfig(uint64_t generation, AnalysisParams& params) {
+    const std::string configPath = getConfigPath(analyzer_.getVideoInfo().path);
     if (!std::filesystem::exists(configPath)) return false;
 
     cv::FileStorage fs(configPath, cv::FileStorage::READ);
@@ -611,61 +896,108 @@ bool App::loadConfig() {
         return false;
     }
 
+    // Each part is shown as soon as it is parsed, unless another load started
+    auto publish = [&](const std::function<void()>& apply) {
+        {
+            std::lock_guard<std::mutex> lock(loadMutex_);
+            if (generation != loadGeneration_) return false;
+            apply();
+        }
+        requestRedraw();
+        return true;
+    };
+
     // Read params
     cv::FileNode paramsNode = fs["params"];
     if (!paramsNode.empty()) {
-        params_.intervalSec = static_cast<float>(paramsNode["interval_sec"]);
-        params_.searchWindowSec = static_cast<float>(paramsNode["search_window_sec"]);
-        params_.searchStepSec = static_cast<float>(paramsNode["search_step_sec"]);
-        params_.sampleStepSec = static_cast<float>(paramsNode["sample_step_sec"]);
+        params.intervalSec = static_cast<float>(paramsNode["interval_sec"]);
+        params.searchWindowSec = static_cast<float>(paramsNode["search_window_sec"]);
+        params.searchStepSec = static_cast<float>(paramsNode["search_step_sec"]);
+        if (!paramsNode["snap_window_sec"].empty()) {
+            params.snapWindowSec = static_cast<float>(paramsNode["snap_window_sec"]);
+        }
+        params.sampleStepSec = static_cast<float>(paramsNode["sample_step_sec"]);
+        params.decodeReduction = std::max(1, static_cast<int>(paramsNode["decode_reduction"]));
 
         std::string algoStr;
         paramsNode["algorithm"] >> algoStr;
-        params_.algorithm = (algoStr == "FFT") ? SharpnessAlgorithm::FFT : SharpnessAlgorithm::Laplacian;
+        params.algorithm = (algoStr == "FFT") ? SharpnessAlgorithm::FFT : SharpnessAlgorithm::Laplacian;
+
+        std::string scanStr;
+        paramsNode["scan_mode"] >> scanStr;
+        params.scanMode = (scanStr == "Keyframes") ? ScanMode::Keyframes : ScanMode::Full;
+        params.codecPrefilter = static_cast<int>(paramsNode["codec_prefilter"]) != 0;
+        params.useProxy = static_cast<int>(paramsNode["use_proxy"]) != 0;
+
+        if (!publish([&]() { loadedParams_ = params; })) return false;
     }
 
     // Read samples (graph data)
     cv::FileNode samplesNode = fs["samples"];
     if (!samplesNode.empty()) {
-        std::lock_guard<std::mutex> lock(samplesMutex_);
-        allSamples_.clear();
+        std::vector<FrameData> samples;
         for (const auto& sn : samplesNode) {
             FrameData fd;
             fd.time = static_cast<double>(sn["time"]);
+            fd.frameIndex = sn["frame"].empty() ? -1 : static_cast<int>(sn["frame"]);
             fd.sharpness = static_cast<double>(sn["sharpness"]);
+            fd.motion = sn["motion"].empty() ? -1.0f : static_cast<float>(sn["motion"]);
             fd.selected = false;
-            allSamples_.push_back(fd);
+            samples.push_back(fd);
         }
+        sortByTime(samples);
+        if (!publish([&]() { allSamples_.publish(std::move(samples)); })) return false;
     }
 
     // Read selected frames
-    selectedFrames_.clear();
+    std::vector<FrameData> selected;
     cv::FileNode framesNode = fs["selected_frames"];
     for (const auto& fn : framesNode) {
         FrameData fd;
         fd.time = static_cast<double>(fn["time"]);
+        fd.frameIndex = fn["frame"].empty() ? -1 : static_cast<int>(fn["frame"]);
         fd.sharpness = static_cast<double>(fn["sharpness"]);
         fd.selected = true;
 
-        // Load thumbnail for this frame
-        cv::Mat frame;
-        if (analyzer_.getFrameAt(fd.time, frame)) {
-            const int thumbHeight = 120;
-            const int thumbWidth = static_cast<int>(thumbHeight * frame.cols / frame.rows);
-            cv::resize(frame, fd.thumbnail, cv::Size(thumbWidth, thumbHeight));
+        // Configs without frame indices map by time
+        if (fd.frameIndex < 0) {
+            fd.frameIndex = analyzer_.frameAtTime(fd.time);
         }
 
-        selectedFrames_.push_back(fd);
+        selected.push_back(fd);
     }
-
+    sortByTime(selected);
     fs.release();
-    configDirty_ = false;
 
-    return true;
+    // Thumbnails follow in timeline order
+    std::vector<int> thumbnails;
+    thumbnails.reserve(selected.size());
+    for (const auto& frame : selected) {
+        thumbnails.push_back(frame.frameIndex);
+    }
+    return publish([&]() {
+        selectedFrames_.publish(std::move(selected));
+        thumbnailWorker_.prefetch(std::move(thumbnails));
+    });
+}
+
+void App::runStatsThread() {
+    std::unique_lock<std::mutex> lock(perfMutex_);
+    while (!statsStopping_) {
+        lock.unlock();
+        updatePerfStats();
+        // Idle windows stay asleep unless the stats are on screen
+        if (perfVisible_.load()) {
+            requestRedraw();
+        }
+        lock.lock();
+        statsWake_.wait_for(lock, kStatsInterval, [this]() { return statsStopping_; });
+    }
 }
 
 void App::updatePerfStats() {
     // Read CPU usage from /proc/stat
+    long long idleTime = -1, totalTime = -1;
     std::ifstream statFile("/proc/stat");
     if (statFile.is_open()) {
         std::string cpu;
@@ -673,9 +1005,26 @@ void App::updatePerfStats() {
         statFile >> cpu >> user >> nice >> system >> idle >> iowait >> irq >> softirq >> steal;
         statFile.close();
 
-        long long idleTime = idle + iowait;
-        long long totalTime = user + nice + system + idle + iowait + irq + softirq + steal;
+        idleTime = idle + iowait;
+        totalTime = user + nice + system + idle + iowait + irq + softirq + steal;
+    }
+
+    // Try to read GPU usage (AMD via sysfs)
+    float gpu = 0.0f;
+    std::ifstream gpuFile("/sys/class/drm/card0/device/gpu_busy_percent");
+    if (!gpuFile.is_open()) {
+        // Try card1 (some systems have card0 as integrated)
+        gpuFile.open("/sys/class/drm/card1/device/gpu_busy_percent");
+    }
+    if (gpuFile.is_open()) {
+        int gpuPercent = 0;
+        gpuFile >> gpuPercent;
+        gpu = static_cast<float>(gpuPercent);
+    }
+    // Otherwise (e.g. NVIDIA without NVML) show 0
 
+    std::lock_guard<std::mutex> lock(perfMutex_);
+    if (totalTime >= 0) {
         if (perfStats_.prevTotalTime > 0) {
             long long totalDelta = totalTime - perfStats_.prevTotalTime;
             long long idleDelta = idleTime - perfStats_.prevIdleTime;
@@ -687,28 +1036,7 @@ void App::updatePerfStats() {
         perfStats_.prevIdleTime = idleTime;
         perfStats_.prevTotalTime = totalTime;
     }
-
-    // Try to read GPU usage (AMD via sysfs)
-    std::ifstream gpuFile("/sys/class/drm/card0/device/gpu_busy_percent");
-    if (gpuFile.is_open()) {
-        int gpuPercent = 0;
-        gpuFile >> gpuPercent;
-        gpuFile.close();
-        perfStats_.currentGpu = static_cast<float>(gpuPercent);
-    } else {
-        // Try card1 (some systems have card0 as integrated)
-        gpuFile.open("/sys/class/drm/card1/device/gpu_busy_percent");
-        if (gpuFile.is_open()) {
-            int gpuPercent = 0;
-            gpuFile >> gpuPercent;
-            gpuFile.close();
-            perfStats_.currentGpu = static_cast<float>(gpuPercent);
-        } else {
-            // Try NVIDIA (nvidia-smi leaves a file or we could use NVML)
-            // For simplicity, show 0 if no GPU stats available
-            perfStats_.currentGpu = 0.0f;
-        }
-    }
+    perfStats_.currentGpu = gpu;
 
     // Update history ring buffer
     perfStats_.cpuHistory[perfStats_.historyIndex] = perfStats_.currentCpu;
@@ -1,13 +1,22 @@
 #pragma once
 
 #include "core/video_analyzer.hpp"
+#include "snapshot.hpp"
+#include "preview_worker.hpp"
+#include "thumbnail_worker.hpp"
+#include "refine_worker.hpp"
+#include "snap_worker.hpp"
 #include <SDL.h>
+#include <memory>
 #include <string>
 #include <thread>
 #include <atomic>
 #include <mutex>
 #include <array>
 #include <chrono>
+#include <condition_variable>
+#include <optional>
+#include <cstdint>
 
 struct SDL_Window;
 typedef void* SDL_GLContext;
@@ -26,7 +35,7 @@ struct SearchState {
 
 // Performance monitoring data
 struct PerfStats {
-    static constexpr size_t HISTORY_SIZE = 120;  // ~2 seconds at 60fps
+    static constexpr size_t HISTORY_SIZE = 120;  // 30 seconds at 4 Hz
 
     std::array<float, HISTORY_SIZE> cpuHistory{};
     std::array<float, HISTORY_SIZE> gpuHistory{};
@@ -53,42 +62,70 @@ public:
     VideoAnalyzer& getAnalyzer() { return analyzer_; }
     VideoInfo& getVideoInfo() { return videoInfo_; }
     AnalysisParams& getParams() { return params_; }
-    std::vector<FrameData> getAllSamples() {
-        std::lock_guard<std::mutex> lock(samplesMutex_);
-        return allSamples_;
-    }
-    std::vector<FrameData>& getSelectedFrames() { return selectedFrames_; }
+    ExportFormat& getExportFormat() { return exportFormat_; }
+    // Run analysis at low CPU and I/O priority, capped at params.cpuCapPercent
+    bool& getBackgroundMode() { return backgroundMode_; }
+
+    // Analysis results, published as immutable snapshots (see snapshot.hpp).
+    // Holding the returned pointer keeps that version alive; compare
+    // `version` to tell whether anything changed since the last look.
+    using FramesSnapshot = Published<std::vector<FrameData>>::Ptr;
+    FramesSnapshot getAllSamples() const { return allSamples_.load(); }
+    FramesSnapshot getSelectedFrames() const { return selectedFrames_.load(); }
 
     // Progress tracking
     float getProgress() const { return progress_.load(); }
     std::string getStatusText();
     bool isAnalyzing() const { return analyzing_.load(); }
+    bool isLoading() const { return loading_.load(); }
     float getRemainingSeconds() const;
 
     // Actions
+    // Open a video in the background. Metadata shows up first, then the
+    // saved config's curve and selection, then thumbnails in timeline order.
     void loadVideo(const std::string& path);
     void startAnalysis();
     void cancelAnalysis();
     void exportFrames(const std::string& outputDir);
 
-    // Config save/load
+    // Config save (loading is part of loadVideo)
     bool saveConfig();
-    bool loadConfig();
     bool hasUnsavedChanges() const { return configDirty_; }
     void markConfigDirty() { configDirty_ = true; }
 
     // Preview state
     void setHoveredTime(double time) { hoveredTime_ = time; }
     double getHoveredTime() const { return hoveredTime_; }
-    void setPreviewFrame(const cv::Mat& frame) {
+    // Decode the preview for `time` in the background; the result arrives
+    // through setPreviewFrame
+    void requestPreview(double time) { previewWorker_.request(time); }
+    PreviewCache::Stats getPreviewCacheStats() const { return previewWorker_.getCacheStats(); }
+    PreviewWorker::LatencyStats getPreviewLatency() const { return previewWorker_.getLatencyStats(); }
+
+    // Thumbnail of a frame if generated, else queue it for the background worker
+    bool getThumbnail(int frameIndex, cv::Mat& out) { return thumbnailWorker_.get(frameIndex, out); }
+
+    // Score up to `maxFrames` more curve samples between the two times,
+    // merged into getAllSamples() as they arrive. Only the latest range is
+    // worked on, and not while a pass runs or a video is opening.
+    void requestRefinement(double startSec, double endSec, int maxFrames);
+    bool isRefining() const { return refineWorker_.isBusy(); }
+
+    // Preview frames change hands by swapping buffers, never by copying:
+    // `frame` receives the buffer previously held (or an empty Mat). `exact`
+    // is false for a stand-in shown while the exact frame is decoded.
+    void setPreviewFrame(cv::Mat& frame, bool exact = true) {
         std::lock_guard<std::mutex> lock(previewMutex_);
-        previewFrame_ = frame.clone();
+        cv::swap(previewFrame_, frame);
         previewDirty_ = true;
+        previewExact_ = exact;
+        requestRedraw();
     }
+    bool isPreviewExact() const { return previewExact_.load(); }
     bool getPreviewFrame(cv::Mat& out) {
         std::lock_guard<std::mutex> lock(previewMutex_);
         if (previewDirty_) {
-            out = previewFrame_.clone();
+            cv::swap(previewFrame_, out);
             previewDirty_ = false;
             return true;
         }
@@ -96,8 +133,12 @@ public:
     }
 
     // Selection management
-    void toggleFrameSelection(int index);
+    // Toggle the listed frame with `frame`'s index (its time if it has none)
+    void toggleFrameSelection(const FrameData& frame);
+    // Add the sharpest frame near `time` once the background search is done
     void addFrameAtTime(double time);
+    // Times of added frames still being searched, for placeholder markers
+    std::vector<double> getPendingAdds() const { return snapWorker_.getPending(); }
     int getSelectedCount() const;
 
     // Search visualization
@@ -110,15 +151,41 @@ public:
         searchState_ = state;
     }
 
-    // Performance stats
-    void updatePerfStats();
-    const PerfStats& getPerfStats() const { return perfStats_; }
+    // Performance stats, sampled on a background thread
+    PerfStats getPerfStats() {
+        std::lock_guard<std::mutex> lock(perfMutex_);
+        return perfStats_;
+    }
+
+    // Called by the panel showing the stats in each frame they are on screen;
+    // new samples only wake the render loop while they are
+    void setPerfStatsVisible() { perfVisible_.store(true); }
+
+    // Summary of the decode plan of the latest pass, empty before the first
+    std::string getDecodePlan() {
+        std::lock_guard<std::mutex> lock(perfMutex_);
+        return decodePlan_;
+    }
+
+    // Wake the render loop for a new frame; callable from any thread
+    void requestRedraw();
 
 private:
     void setupImGuiStyle();
     void setWindowIcon();
     void renderFrame();
-    void handleEvents(bool& running);
+    // Process pending events, first waiting up to `waitMs` for one
+    void handleEvents(bool& running, int waitMs);
+    void updatePerfStats();
+    void runStatsThread();
+
+    // Loader thread: opens the latest requested path
+    void runLoadThread();
+    // Read the config saved next to the open video, publishing each part as
+    // it is parsed while `generation` is still the latest load
+    bool loadConfig(uint64_t generation, AnalysisParams& params);
+    // Take over what the loader has opened and parsed (UI thread)
+    void applyLoaded();
 
     SDL_Window* window_ = nullptr;
     SDL_GLContext glContext_ = nullptr;
@@ -126,8 +193,10 @@ private:
     VideoAnalyzer analyzer_;
     VideoInfo videoInfo_;
     AnalysisParams params_;
-    std::vector<FrameData> allSamples_;
-    std::vector<FrameData> selectedFrames_;
+    ExportFormat exportFormat_ = ExportFormat::JPEG;
+    bool backgroundMode_ = false;
+    Published<std::vector<FrameData>> allSamples_;
+    Published<std::vector<FrameData>> selectedFrames_;
 
     // Threading
     std::thread analysisThread_;
@@ -135,13 +204,19 @@ private:
     std::atomic<float> progress_{0.0f};
     std::string statusText_;
     std::mutex statusMutex_;
-    std::mutex samplesMutex_;
     std::chrono::steady_clock::time_point analysisStartTime_;
 
     // Preview
+    PreviewWorker previewWorker_{analyzer_};
+    ThumbnailWorker thumbnailWorker_{analyzer_};
+    RefineWorker refineWorker_{analyzer_};
+    AnalysisParams curveParams_;  // What allSamples_ was scored with
+    std::array<int, 3> lastRefinement_{};  // First frame, last frame, step
+    SnapWorker snapWorker_{analyzer_};
     double hoveredTime_ = -1.0;
     cv::Mat previewFrame_;
     bool previewDirty_ = false;
+    std::atomic<bool> previewExact_{true};
     std::mutex previewMutex_;
 
     // Search visualization
@@ -153,10 +228,36 @@ private:
     int windowHeight_ = 900;
 
     // Config state
-    bool configDirty_ = false;
+    std::atomic<bool> configDirty_{false};  // Also set by the snap worker
+
+    // Background loading. Results for the UI thread wait in loadedInfo_ and
+    // loadedParams_; everything the loader publishes is checked against
+    // loadGeneration_ under loadMutex_ so a superseded load leaves no trace.
+    std::thread loadThread_;
+    std::mutex loadMutex_;
+    std::condition_variable loadWake_;
+    std::string loadPath_;  // Next path to open, empty if none
+    AnalysisParams loadParams_;  // Defaults for what the config leaves out
+    bool loadStopping_ = false;
+    uint64_t loadGeneration_ = 0;
+    std::atomic<bool> loading_{false};
+    std::optional<VideoInfo> loadedInfo_;
+    std::optional<AnalysisParams> loadedParams_;
+
+    // Idle rendering: the loop sleeps in SDL_WaitEventTimeout until input or
+    // a wake-up event arrives, then renders a few frames for ImGui to settle
+    Uint32 wakeEventType_ = 0;
+    std::atomic<bool> wakePending_{false};
+    int activeFrames_ = 0;
 
     // Performance monitoring
     PerfStats perfStats_;
+    std::atomic<bool> perfVisible_{true};  // Reset before every frame's panels
+    std::string decodePlan_;
+    std::mutex perfMutex_;
+    std::thread statsThread_;
+    std::condition_variable statsWake_;
+    bool statsStopping_ = false;
 };
 
 }  // namespace sharpctl
@@ -1,5 +1,7 @@
 #include "control_panel.hpp"
 #include "../app.hpp"
+#include "core/proxy_source.hpp"
+#include "core/frame_pool.hpp"
 
 #include <imgui.h>
 #include <implot.h>
@@ -12,6 +14,12 @@ namespace fs = std::filesystem;
 
 namespace sharpctl::gui {
 
+namespace {
+
+constexpr double kPreviewLatencyTargetMs = 100.0;
+
+}  // anonymous namespace
+
 void renderControlPanel(App& app) {
     ImGui::SetNextWindowSize(ImVec2(280, 400), ImGuiCond_FirstUseEver);
 
@@ -23,6 +31,7 @@ void renderControlPanel(App& app) {
     const auto& videoInfo = app.getVideoInfo();
     auto& params = app.getParams();
     bool isAnalyzing = app.isAnalyzing();
+    bool isLoading = app.isLoading();
 
     // Load Video section
     ImGui::SeparatorText("Video");
@@ -30,12 +39,21 @@ void renderControlPanel(App& app) {
     ImGui::BeginDisabled(isAnalyzing);
     if (ImGui::Button("Load Video", ImVec2(-1, 0))) {
         auto selection = pfd::open_file("Select video file", ".",
-            { "Video files", "*.mp4 *.avi *.mkv *.mov *.webm",
+            { "Video files", "*.mp4 *.avi *.mkv *.mov *.webm *.y4m *.yuv",
               "All files", "*" }).result();
         if (!selection.empty()) {
             app.loadVideo(selection[0]);
         }
     }
+    if (ImGui::Button("Load Image Folder", ImVec2(-1, 0))) {
+        auto folder = pfd::select_folder("Select image sequence folder", ".").result();
+        if (!folder.empty()) {
+            app.loadVideo(folder);
+        }
+    }
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Directory of JPEG/PNG/TIFF stills, read in filename order");
+    }
     ImGui::EndDisabled();
 
     // Video info
@@ -53,7 +71,38 @@ void renderControlPanel(App& app) {
 
         ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.65f, 1.0f), "Resolution:");
         ImGui::SameLine();
-        ImGui::Text("%dx%d", videoInfo.width, videoInfo.height);
+        if (videoInfo.bitDepth > 8) {
+            ImGui::Text("%dx%d (%d-bit)", videoInfo.width, videoInfo.height, videoInfo.bitDepth);
+        } else {
+            ImGui::Text("%dx%d", videoInfo.width, videoInfo.height);
+        }
+
+        // Scrub proxy (long-GOP video only)
+        if (ImGui::Checkbox("Scrub proxy", &params.useProxy)) {
+            app.markConfigDirty();
+            if (params.useProxy) {
+                app.getAnalyzer().startProxy();
+            }
+        }
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("Write a %dp all-intra copy next to the video for fast scrubbing\n"
+                              "and graph analysis; selection and export still use the original",
+                              ProxySource::kProxyHeight);
+        }
+        if (params.useProxy) {
+            ImGui::SameLine();
+            if (app.getAnalyzer().isBuildingProxy()) {
+                ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.65f, 1.0f), "building %.0f%%",
+                                   app.getAnalyzer().getProxyProgress() * 100.0f);
+            } else if (app.getAnalyzer().hasProxy()) {
+                ImGui::TextColored(ImVec4(0.3f, 0.9f, 0.4f, 1.0f), "ready");
+            } else {
+                ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.52f, 1.0f), "not needed");
+            }
+        }
+    } else if (isLoading) {
+        ImGui::Spacing();
+        ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.52f, 1.0f), "Opening...");
     } else {
         ImGui::Spacing();
         ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.52f, 1.0f), "No video loaded");
@@ -67,7 +116,8 @@ void renderControlPanel(App& app) {
     // Parameters section
     ImGui::SeparatorText("Parameters");
 
-    ImGui::BeginDisabled(isAnalyzing);
+    // Disabled while loading: the saved config replaces them once it is read
+    ImGui::BeginDisabled(isAnalyzing || isLoading);
 
     ImGui::SetNextItemWidth(-1);
     if (ImGui::SliderFloat("##interval", &params.intervalSec, 0.5f, 30.0f, "Interval: %.1f sec")) {
@@ -96,6 +146,15 @@ void renderControlPanel(App& app) {
         ImGui::SetTooltip("Step size for searching within the window");
     }
 
+    ImGui::SetNextItemWidth(-1);
+    if (ImGui::SliderFloat("##snap", &params.snapWindowSec, 0.0f, 1.0f, "Snap: %.2f sec")) {
+        params.snapWindowSec = std::max(0.0f, params.snapWindowSec);
+        app.markConfigDirty();
+    }
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Right-click adds the sharpest frame within this distance (+/-)");
+    }
+
     ImGui::Spacing();
 
     const char* algorithms[] = {
@@ -108,7 +167,7 @@ void renderControlPanel(App& app) {
         params.algorithm = static_cast<SharpnessAlgorithm>(currentAlgo);
         app.markConfigDirty();
         // Re-analyze if we already have data
-        if (!app.getAllSamples().empty()) {
+        if (!app.getAllSamples()->value.empty()) {
             app.startAnalysis();
         }
     }
@@ -116,6 +175,60 @@ void renderControlPanel(App& app) {
         ImGui::SetTooltip("Sharpness detection algorithm");
     }
 
+    const char* reductions[] = {
+        "Scoring scale: full",
+        "Scoring scale: 1/2",
+        "Scoring scale: 1/4",
+        "Scoring scale: 1/8"
+    };
+    int currentReduction = 0;
+    while ((1 << currentReduction) < params.decodeReduction && currentReduction < 3) {
+        currentReduction++;
+    }
+    ImGui::SetNextItemWidth(-1);
+    if (ImGui::Combo("##reduction", &currentReduction, reductions, 4)) {
+        params.decodeReduction = 1 << currentReduction;
+        app.markConfigDirty();
+    }
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Score on downscaled luma (faster; image folders decode at reduced size).\n"
+                          "Frames larger than 720p are scored at the scale that fits it,\n"
+                          "so re-analysis can reuse their decoded luma");
+    }
+    const int scoredReduction = app.getVideoInfo().isValid()
+        ? app.getAnalyzer().scoringReductionFor(params.decodeReduction) : params.decodeReduction;
+    if (scoredReduction != params.decodeReduction) {
+        ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.65f, 1.0f), "Scored at 1/%d to fit the luma cache", scoredReduction);
+    }
+
+    const char* scanModes[] = {
+        "Scan: every sample step",
+        "Scan: keyframes only"
+    };
+    int currentScan = static_cast<int>(params.scanMode);
+    ImGui::SetNextItemWidth(-1);
+    if (ImGui::Combo("##scanmode", &currentScan, scanModes, 2)) {
+        params.scanMode = static_cast<ScanMode>(currentScan);
+        app.markConfigDirty();
+    }
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Keyframes only decodes just the intra frames: a much faster, coarser\n"
+                          "curve and selection for long videos (needs a keyframe index)");
+    }
+
+    ImGui::BeginDisabled(!codecSideDataAvailable());
+    if (ImGui::Checkbox("Codec prefilter", &params.codecPrefilter)) {
+        app.markConfigDirty();
+    }
+    ImGui::EndDisabled();
+    if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled)) {
+        ImGui::SetTooltip(codecSideDataAvailable()
+            ? "Skip high-motion and heavily quantized frames using decoder motion vectors\n"
+              "and QP before scoring; adds a motion curve to the timeline.\n"
+              "Reading them takes one extra, lighter decode of the whole video per load"
+            : "Not available: built without FFmpeg development files");
+    }
+
     ImGui::EndDisabled();
 
     ImGui::Spacing();
@@ -147,6 +260,18 @@ void renderControlPanel(App& app) {
             ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.65f, 1.0f), "Remaining: estimating...");
         }
 
+        // Decoding rate, to weigh a CPU cap against how long the pass takes
+        const VideoAnalyzer::Throughput throughput = app.getAnalyzer().getThroughput();
+        if (throughput.frames > 0) {
+            if (throughput.cpuCapPercent < 100) {
+                ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.65f, 1.0f), "Throughput: %.0f frames/s (CPU cap %d%%)",
+                                   throughput.framesPerSec(), throughput.cpuCapPercent);
+            } else {
+                ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.65f, 1.0f), "Throughput: %.0f frames/s",
+                                   throughput.framesPerSec());
+            }
+        }
+
         ImGui::Spacing();
         if (ImGui::Button("Cancel", ImVec2(-1, 0))) {
             app.cancelAnalysis();
@@ -155,15 +280,29 @@ void renderControlPanel(App& app) {
             ImGui::SetTooltip("Press Escape to cancel");
         }
     } else {
-        ImGui::BeginDisabled(!videoInfo.isValid());
+        ImGui::BeginDisabled(!videoInfo.isValid() || isLoading);
         if (ImGui::Button("Analyze Video", ImVec2(-1, 0))) {
             app.startAnalysis();
         }
         ImGui::EndDisabled();
 
-        if (!videoInfo.isValid() && ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled)) {
+        if (isLoading && ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled)) {
+            ImGui::SetTooltip("Wait for the video to finish loading");
+        } else if (!videoInfo.isValid() && ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled)) {
             ImGui::SetTooltip("Load a video first");
         }
+
+        ImGui::Checkbox("Background mode", &app.getBackgroundMode());
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("Analyze at low CPU and disk priority so other programs stay responsive");
+        }
+        if (app.getBackgroundMode()) {
+            ImGui::SetNextItemWidth(-1);
+            ImGui::SliderInt("##cpucap", &params.cpuCapPercent, DutyCycle::kMinPercent, 100, "CPU cap: %d%%");
+            if (ImGui::IsItemHovered()) {
+                ImGui::SetTooltip("Pause workers between frames to use about this share of the CPU");
+            }
+        }
     }
 
     ImGui::Spacing();
@@ -176,6 +315,20 @@ void renderControlPanel(App& app) {
     int selectedCount = app.getSelectedCount();
     ImGui::TextColored(ImVec4(0.26f, 0.75f, 0.75f, 1.0f), "Selected frames: %d", selectedCount);
 
+    const char* formats[] = {
+        "Format: JPEG",
+        "Format: PNG",
+        "Format: TIFF"
+    };
+    int currentFormat = static_cast<int>(app.getExportFormat());
+    ImGui::SetNextItemWidth(-1);
+    if (ImGui::Combo("##format", &currentFormat, formats, 3)) {
+        app.getExportFormat() = static_cast<ExportFormat>(currentFormat);
+    }
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("PNG and TIFF keep 16 bits per channel for high bit depth sources");
+    }
+
     ImGui::BeginDisabled(isAnalyzing || selectedCount == 0);
     if (ImGui::Button("Export Frames", ImVec2(-1, 0))) {
         auto folder = pfd::select_folder("Select output folder", ".").result();
@@ -196,7 +349,7 @@ void renderControlPanel(App& app) {
     ImGui::Spacing();
 
     // Save Config button
-    ImGui::BeginDisabled(isAnalyzing || !videoInfo.isValid());
+    ImGui::BeginDisabled(isAnalyzing || isLoading || !videoInfo.isValid());
     std::string saveLabel = app.hasUnsavedChanges() ? "Save Config *" : "Save Config";
     if (ImGui::Button(saveLabel.c_str(), ImVec2(-1, 0))) {
         app.saveConfig();
@@ -224,9 +377,10 @@ void renderControlPanel(App& app) {
     ImGui::Spacing();
 
     // Performance Stats Graph
+    const ImVec2 perfTop = ImGui::GetCursorScreenPos();
     ImGui::SeparatorText("Performance");
 
-    const auto& perfStats = app.getPerfStats();
+    const PerfStats perfStats = app.getPerfStats();
 
     // Show current values
     ImGui::TextColored(ImVec4(0.4f, 0.8f, 1.0f, 1.0f), "CPU:");
@@ -237,6 +391,80 @@ void renderControlPanel(App& app) {
     ImGui::SameLine();
     ImGui::Text("%.0f%%", perfStats.currentGpu);
 
+    // Decoded luma kept for re-analysis
+    const LumaCache::Stats cacheStats = app.getAnalyzer().getLumaCacheStats();
+    if (cacheStats.entries > 0) {
+        ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.65f, 1.0f), "Luma cache:");
+        ImGui::SameLine();
+        ImGui::Text("%zu frames, %.0f MB%s", cacheStats.entries, cacheStats.bytesStored / (1024.0 * 1024.0),
+                    LumaCache::isCompressed() ? "" : " (uncompressed)");
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("%.0f MB uncompressed, %zu hits / %zu misses",
+                              cacheStats.bytesRaw / (1024.0 * 1024.0), cacheStats.hits, cacheStats.misses);
+        }
+    }
+
+    // Decoded hover previews
+    const PreviewCache::Stats previewStats = app.getPreviewCacheStats();
+    if (previewStats.hits + previewStats.misses > 0) {
+        ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.65f, 1.0f), "Preview cache:");
+        ImGui::SameLine();
+        ImGui::Text("%.0f%% hits, %zu frames, %.0f MB",
+                    100.0 * previewStats.hits / (previewStats.hits + previewStats.misses),
+                    previewStats.entries, previewStats.bytes / (1024.0 * 1024.0));
+    }
+
+    // Hover response; should stay under kPreviewLatencyTargetMs even during analysis
+    const PreviewWorker::LatencyStats latency = app.getPreviewLatency();
+    if (latency.count > 0) {
+        ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.65f, 1.0f), "Preview latency:");
+        ImGui::SameLine();
+        const ImVec4 color = latency.meanMs <= kPreviewLatencyTargetMs ? ImVec4(0.3f, 0.9f, 0.4f, 1.0f)
+                                                                       : ImVec4(1.0f, 0.5f, 0.3f, 1.0f);
+        ImGui::TextColored(color, "%.0f ms avg, %.0f ms max", latency.meanMs, latency.maxMs);
+        if (ImGui::IsItemHovered()) {
+            const InteractiveGate::Stats gateStats = app.getAnalyzer().interactiveGate().getStats();
+            ImGui::SetTooltip("Hover to first frame shown, last %zu requests (latest %.0f ms)\n"
+                              "Background decoding yielded %llu times, %.1f s in total",
+                              latency.count, latency.lastMs,
+                              static_cast<unsigned long long>(gateStats.yields), gateStats.yieldedMs / 1000.0);
+        }
+    }
+
+    // Recycled frame buffers
+    const FramePool::Stats poolStats = FramePool::instance().getStats();
+    if (poolStats.reused + poolStats.allocated > 0) {
+        ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.65f, 1.0f), "Frame pool:");
+        ImGui::SameLine();
+        ImGui::Text("%.0f%% reused, %.0f MB idle",
+                    100.0 * poolStats.reused / (poolStats.reused + poolStats.allocated),
+                    poolStats.freeBytes / (1024.0 * 1024.0));
+    }
+
+    // Decoders per consumer; each seeks independently
+    for (size_t i = 0; i < kDecoderUseCount; ++i) {
+        const DecoderUse use = static_cast<DecoderUse>(i);
+        const DecoderStats::Snapshot decoderStats = app.getAnalyzer().getDecoderStats(use);
+        if (decoderStats.frames == 0) continue;
+
+        ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.65f, 1.0f), "%s decoder:", decoderUseName(use));
+        ImGui::SameLine();
+        ImGui::Text("%.1f ms/frame, %llu seeks", decoderStats.meanMs(),
+                    static_cast<unsigned long long>(decoderStats.seeks));
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("%llu frames, slowest %.1f ms",
+                              static_cast<unsigned long long>(decoderStats.frames), decoderStats.maxMs);
+        }
+    }
+
+    // Schedule of the latest pass
+    const std::string decodePlan = app.getDecodePlan();
+    if (!decodePlan.empty()) {
+        ImGui::PushTextWrapPos(0.0f);
+        ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.65f, 1.0f), "%s", decodePlan.c_str());
+        ImGui::PopTextWrapPos();
+    }
+
     // Prepare data for plotting (handle ring buffer wrap-around)
     static std::array<float, PerfStats::HISTORY_SIZE> cpuPlot, gpuPlot, xAxis;
     static bool xAxisInit = false;
@@ -279,6 +507,12 @@ void renderControlPanel(App& app) {
         ImPlot::EndPlot();
     }
 
+    // The stats thread only wakes the render loop while this is on screen
+    const ImVec2 perfBottom(perfTop.x + ImGui::GetContentRegionAvail().x, ImGui::GetCursorScreenPos().y);
+    if (ImGui::IsRectVisible(perfTop, perfBottom)) {
+        app.setPerfStatsVisible();
+    }
+
     ImGui::End();
 }
 
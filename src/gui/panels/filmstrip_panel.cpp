@@ -0,0 +1,142 @@
+#include "filmstrip_panel.hpp"
+#include "../app.hpp"
+#include "../widgets/thumbnail_atlas.hpp"
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+
+namespace sharpctl::gui {
+
+namespace {
+
+constexpr float kThumbHeight = 72.0f;     // Displayed thumbnail height
+constexpr int kMaxUploadsPerFrame = 8;    // Atlas uploads per UI frame, to spread the cost
+
+// Static atlas (persists across frames), valid for one video
+std::unique_ptr<ThumbnailAtlas> s_atlas;
+std::string s_atlasVideo;
+
+}  // anonymous namespace
+
+void renderFilmstripPanel(App& app) {
+    ImGui::SetNextWindowSize(ImVec2(800, 200), ImGuiCond_FirstUseEver);
+
+    if (!ImGui::Begin("Filmstrip")) {
+        ImGui::End();
+        return;
+    }
+
+    const App::FramesSnapshot selected = app.getSelectedFrames();
+    const std::vector<FrameData>& frames = selected->value;
+    const VideoInfo& videoInfo = app.getVideoInfo();
+
+    if (frames.empty()) {
+        ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.52f, 1.0f), "No selected frames yet.");
+        ImGui::End();
+        return;
+    }
+
+    // Initialize atlas on first use; thumbnails are keyed by frame index of the open video
+    if (!s_atlas) {
+        s_atlas = std::make_unique<ThumbnailAtlas>();
+    }
+    if (s_atlasVideo != videoInfo.path) {
+        s_atlas->clear();
+        s_atlasVideo = videoInfo.path;
+    }
+
+    const float aspect = videoInfo.height > 0 ? static_cast<float>(videoInfo.width) / videoInfo.height : 16.0f / 9.0f;
+    const ImVec2 thumbSize(std::round(kThumbHeight * aspect), kThumbHeight);
+    const ImGuiStyle& style = ImGui::GetStyle();
+    const float cellWidth = thumbSize.x + style.ItemSpacing.x;
+    const float rowHeight = thumbSize.y + ImGui::GetTextLineHeight() + 2.0f * style.ItemSpacing.y;
+
+    const int columns = std::max(1, static_cast<int>((ImGui::GetContentRegionAvail().x + style.ItemSpacing.x) / cellWidth));
+    const int count = static_cast<int>(frames.size());
+    const int rows = (count + columns - 1) / columns;
+
+    static int s_hovered = -1;
+    int hovered = -1;
+    int uploads = 0;
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+
+    // Only rows in view are laid out, uploaded and drawn
+    ImGuiListClipper clipper;
+    clipper.Begin(rows, rowHeight);
+    while (clipper.Step()) {
+        for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+            for (int col = 0; col < columns; ++col) {
+                const int i = row * columns + col;
+                if (i >= count) break;
+                const FrameData& frame = frames[i];
+                const int key = frame.frameIndex >= 0 ? frame.frameIndex : app.getAnalyzer().frameAtTime(frame.time);
+
+                // Thumbnails from the analysis are used as they are; others are generated in the background
+                ThumbnailAtlas::Slot slot;
+                bool ready = s_atlas->find(key, slot);
+                if (!ready && uploads < kMaxUploadsPerFrame) {
+                    cv::Mat thumbnail = frame.thumbnail;
+                    if (thumbnail.empty()) {
+                        app.getThumbnail(key, thumbnail);
+                    }
+                    if (!thumbnail.empty()) {
+                        s_atlas->add(key, thumbnail);
+                        uploads++;
+                        ready = s_atlas->find(key, slot);
+                    }
+                }
+
+                if (col > 0) {
+                    ImGui::SameLine();
+                }
+                ImGui::BeginGroup();
+                ImGui::PushID(i);
+
+                const ImVec2 pos = ImGui::GetCursorScreenPos();
+                const ImVec2 end(pos.x + thumbSize.x, pos.y + thumbSize.y);
+                if (ready) {
+                    ImGui::Image(static_cast<ImTextureID>(s_atlas->getTextureID()), thumbSize,
+                                 ImVec2(slot.u0, slot.v0), ImVec2(slot.u1, slot.v1));
+                    if (!frame.selected) {
+                        drawList->AddRectFilled(pos, end, ImGui::GetColorU32(ImVec4(0.1f, 0.1f, 0.12f, 0.65f)));
+                    }
+                } else {
+                    ImGui::InvisibleButton("##pending", thumbSize);
+                    drawList->AddRectFilled(pos, end, ImGui::GetColorU32(ImVec4(0.16f, 0.16f, 0.18f, 1.0f)));
+                }
+                if (ImGui::IsItemHovered()) {
+                    hovered = i;
+                }
+
+                // Left-click toggles selection, as on the timeline
+                if (ImGui::IsItemClicked(ImGuiMouseButton_Left)) {
+                    app.toggleFrameSelection(frame);
+                }
+                drawList->AddRect(pos, end, ImGui::GetColorU32(frame.selected ? ImVec4(0.3f, 0.9f, 0.4f, 1.0f)
+                                                                              : ImVec4(0.35f, 0.35f, 0.38f, 1.0f)));
+
+                const int mins = static_cast<int>(frame.time) / 60;
+                const double secs = frame.time - mins * 60;
+                ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.65f, 1.0f), "%d:%05.2f  %.0f", mins, secs, frame.sharpness);
+
+                ImGui::PopID();
+                ImGui::EndGroup();
+            }
+        }
+    }
+    clipper.End();
+
+    // Show the hovered frame in the preview panel
+    if (hovered >= 0 && hovered != s_hovered) {
+        app.requestPreview(frames[hovered].time);
+    }
+    s_hovered = hovered;
+
+    ImGui::End();
+}
+
+}  // namespace sharpctl::gui
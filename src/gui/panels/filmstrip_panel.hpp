@@ -0,0 +1,11 @@
+#pragma once
+
+namespace sharpctl {
+class App;
+}
+
+namespace sharpctl::gui {
+
+void renderFilmstripPanel(App& app);
+
+}  // namespace sharpctl::gui
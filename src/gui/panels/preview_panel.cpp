@@ -10,6 +10,8 @@ namespace sharpctl::gui {
 
 // Static texture for preview (persists across frames)
 static std::unique_ptr<FrameTexture> s_previewTexture;
+// Last frame taken from the app; swapped back as the next frame's buffer
+static cv::Mat s_previewFrame;
 
 void renderPreviewPanel(App& app) {
     ImGui::SetNextWindowSize(ImVec2(400, 350), ImGuiCond_FirstUseEver);
@@ -25,13 +27,13 @@ void renderPreviewPanel(App& app) {
     }
 
     // Update texture if new frame available
-    cv::Mat frame;
-    if (app.getPreviewFrame(frame)) {
-        s_previewTexture->upload(frame);
+    if (app.getPreviewFrame(s_previewFrame)) {
+        s_previewTexture->upload(s_previewFrame);
     }
 
     double hoveredTime = app.getHoveredTime();
-    const auto& selectedFrames = app.getSelectedFrames();
+    const App::FramesSnapshot selected = app.getSelectedFrames();
+    const std::vector<FrameData>& selectedFrames = selected->value;
 
     // Display preview image
     if (s_previewTexture->isValid()) {
@@ -70,22 +72,18 @@ void renderPreviewPanel(App& app) {
             bool isSelected = false;
 
             // Check if this time matches a selected frame
-            for (const auto& sf : selectedFrames) {
-                if (std::abs(sf.time - hoveredTime) < 0.1) {
-                    sharpness = sf.sharpness;
-                    isSelected = sf.selected;
-                    break;
-                }
+            const int selectedIdx = findNearestByTime(selectedFrames, hoveredTime, 0.1);
+            if (selectedIdx >= 0) {
+                sharpness = selectedFrames[selectedIdx].sharpness;
+                isSelected = selectedFrames[selectedIdx].selected;
             }
 
             // If not found in selected, estimate from all samples
             if (sharpness == 0.0) {
-                const auto& allSamples = app.getAllSamples();
-                for (const auto& sample : allSamples) {
-                    if (std::abs(sample.time - hoveredTime) < 0.1) {
-                        sharpness = sample.sharpness;
-                        break;
-                    }
+                const App::FramesSnapshot allSamples = app.getAllSamples();
+                const int sampleIdx = findNearestByTime(allSamples->value, hoveredTime, 0.1);
+                if (sampleIdx >= 0) {
+                    sharpness = allSamples->value[sampleIdx].sharpness;
                 }
             }
 
@@ -108,6 +106,11 @@ void renderPreviewPanel(App& app) {
                 ImGui::SameLine(0, 20);
                 ImGui::TextColored(ImVec4(0.3f, 0.9f, 0.4f, 1.0f), "[SELECTED]");
             }
+
+            if (!app.isPreviewExact()) {
+                ImGui::SameLine(0, 20);
+                ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.52f, 1.0f), "(approximate)");
+            }
         } else {
             ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.52f, 1.0f),
                 "Hover over timeline to preview frames");
@@ -1,16 +1,22 @@
 #include "timeline_panel.hpp"
 #include "../app.hpp"
+#include "../widgets/curve_lod.hpp"
 
 #include <imgui.h>
 #include <implot.h>
 
+#include <algorithm>
 #include <vector>
 #include <cmath>
+#include <cstdint>
 
 namespace sharpctl::gui {
 
 namespace {
 
+// Refine the curve once the visible samples are further apart than this
+constexpr float kPixelsPerSample = 4.0f;
+
 const char* getAlgorithmName(SharpnessAlgorithm algo) {
     switch (algo) {
         case SharpnessAlgorithm::Laplacian: return "Sharpness (Laplacian)";
@@ -19,6 +25,58 @@ const char* getAlgorithmName(SharpnessAlgorithm algo) {
     }
 }
 
+// Plot data derived from the published analysis data, updated only when the
+// samples or the selection change
+struct PlotData {
+    uint64_t samplesVersion = UINT64_MAX;
+    uint64_t selectedVersion = UINT64_MAX;
+    double lastTime = 0.0;  // Time of the last sample added, to detect appends
+
+    CurveLod sharpness;
+    CurveLod motion;  // Codec motion, when the prefilter ran
+    std::vector<double> selectedTimes, selectedSharpness;
+
+    // Visible points of the curves, reused across frames
+    std::vector<double> drawX, drawY;
+};
+
+void updatePlotData(PlotData& plot, const App::FramesSnapshot& samples,
+                    const App::FramesSnapshot& selected) {
+    if (plot.samplesVersion != samples->version) {
+        plot.samplesVersion = samples->version;
+
+        // Live updates during a pass only append; anything else is rebuilt
+        const std::vector<FrameData>& values = samples->value;
+        const size_t built = plot.sharpness.size();
+        const bool appended = built > 0 && built <= values.size() && values[built - 1].time == plot.lastTime;
+        if (!appended) {
+            plot.sharpness.clear();
+            plot.motion.clear();
+        }
+
+        for (size_t i = appended ? built : 0; i < values.size(); ++i) {
+            const FrameData& sample = values[i];
+            plot.sharpness.append(sample.time, sample.sharpness);
+            if (sample.motion >= 0.0f) {
+                plot.motion.append(sample.time, sample.motion);
+            }
+        }
+        plot.lastTime = values.empty() ? 0.0 : values.back().time;
+    }
+
+    if (plot.selectedVersion != selected->version) {
+        plot.selectedVersion = selected->version;
+        plot.selectedTimes.clear();
+        plot.selectedSharpness.clear();
+        for (const auto& frame : selected->value) {
+            if (frame.selected) {
+                plot.selectedTimes.push_back(frame.time);
+                plot.selectedSharpness.push_back(frame.sharpness);
+            }
+        }
+    }
+}
+
 }  // anonymous namespace
 
 void renderTimelinePanel(App& app) {
@@ -29,38 +87,25 @@ void renderTimelinePanel(App& app) {
         return;
     }
 
-    const auto& allSamples = app.getAllSamples();
-    auto& selectedFrames = app.getSelectedFrames();
+    const App::FramesSnapshot allSamples = app.getAllSamples();
+    const App::FramesSnapshot selected = app.getSelectedFrames();
+    const std::vector<FrameData>& selectedFrames = selected->value;
     const auto& videoInfo = app.getVideoInfo();
     const auto& params = app.getParams();
 
-    if (allSamples.empty()) {
+    if (allSamples->value.empty()) {
         ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.52f, 1.0f),
             "No analysis data. Load a video and click Analyze.");
         ImGui::End();
         return;
     }
 
-    // Prepare data arrays for ImPlot
-    std::vector<double> times, sharpness;
-    times.reserve(allSamples.size());
-    sharpness.reserve(allSamples.size());
-
-    double maxSharpness = 0.0;
-    for (const auto& sample : allSamples) {
-        times.push_back(sample.time);
-        sharpness.push_back(sample.sharpness);
-        maxSharpness = std::max(maxSharpness, sample.sharpness);
-    }
-
-    // Prepare selected frame markers
-    std::vector<double> selectedTimes, selectedSharpness;
-    for (const auto& frame : selectedFrames) {
-        if (frame.selected) {
-            selectedTimes.push_back(frame.time);
-            selectedSharpness.push_back(frame.sharpness);
-        }
-    }
+    // Prepare data for ImPlot
+    static PlotData plot;
+    updatePlotData(plot, allSamples, selected);
+    const std::vector<double>& selectedTimes = plot.selectedTimes;
+    const std::vector<double>& selectedSharpness = plot.selectedSharpness;
+    const double maxSharpness = plot.sharpness.getMaxY();
 
     // Calculate plot dimensions, reserving space for help text
     ImVec2 plotSize = ImGui::GetContentRegionAvail();
@@ -76,12 +121,47 @@ void renderTimelinePanel(App& app) {
                           ImPlotAxisFlags_None, ImPlotAxisFlags_AutoFit);
         ImPlot::SetupAxisLimits(ImAxis_X1, 0.0, videoInfo.duration, ImPlotCond_Once);
         ImPlot::SetupAxisLimits(ImAxis_Y1, 0.0, maxSharpness * 1.1, ImPlotCond_Once);
+        const bool hasMotion = plot.motion.size() > 0;
+        if (hasMotion) {
+            ImPlot::SetupAxis(ImAxis_Y2, "Motion (px)", ImPlotAxisFlags_AuxDefault | ImPlotAxisFlags_AutoFit);
+        }
+
+        // Draw about two points per pixel of the visible range; min/max
+        // decimation keeps the peaks of dense curves
+        const ImPlotRect limits = ImPlot::GetPlotLimits();
+        const float plotWidth = ImPlot::GetPlotSize().x;
+        const int maxPoints = 2 * std::max(1, static_cast<int>(plotWidth));
+
+        // Zoomed in past the curve's resolution: score the visible range
+        // more densely in the background
+        if (!app.isAnalyzing()) {
+            const std::vector<FrameData>& values = allSamples->value;
+            const double viewStart = std::max(0.0, limits.X.Min);
+            const double viewEnd = std::min(videoInfo.duration, limits.X.Max);
+            auto byTime = [](const FrameData& frame, double t) { return frame.time < t; };
+            const auto visible = std::lower_bound(values.begin(), values.end(), viewEnd, byTime) -
+                                 std::lower_bound(values.begin(), values.end(), viewStart, byTime);
+            if (viewEnd > viewStart && visible * kPixelsPerSample < plotWidth) {
+                app.requestRefinement(viewStart, viewEnd, static_cast<int>(plotWidth / kPixelsPerSample));
+            }
+        }
 
         // Style for sharpness line
-        ImPlot::PlotLine("Sharpness", times.data(), sharpness.data(),
-                         static_cast<int>(times.size()),
+        plot.sharpness.decimate(limits.X.Min, limits.X.Max, maxPoints, plot.drawX, plot.drawY);
+        ImPlot::PlotLine("Sharpness", plot.drawX.data(), plot.drawY.data(),
+                         static_cast<int>(plot.drawX.size()),
                          ImPlotSpec(ImPlotProp_LineColor, ImVec4(0.26f, 0.75f, 0.75f, 1.0f)));
 
+        // Motion curve on the secondary axis
+        if (hasMotion) {
+            plot.motion.decimate(limits.X.Min, limits.X.Max, maxPoints, plot.drawX, plot.drawY);
+            ImPlot::SetAxes(ImAxis_X1, ImAxis_Y2);
+            ImPlot::PlotLine("Motion", plot.drawX.data(), plot.drawY.data(),
+                             static_cast<int>(plot.drawX.size()),
+                             ImPlotSpec(ImPlotProp_LineColor, ImVec4(0.85f, 0.45f, 0.75f, 0.6f)));
+            ImPlot::SetAxes(ImAxis_X1, ImAxis_Y1);
+        }
+
         // Style for selected frame markers
         if (!selectedTimes.empty()) {
             ImPlot::PlotScatter("Selected", selectedTimes.data(), selectedSharpness.data(),
@@ -93,6 +173,23 @@ void renderTimelinePanel(App& app) {
                                           ImPlotProp_MarkerLineColor, ImVec4(0.2f, 0.7f, 0.3f, 1.0f)));
         }
 
+        // Placeholders for frames added by hand that are still being searched
+        const std::vector<double> pendingTimes = app.getPendingAdds();
+        if (!pendingTimes.empty()) {
+            std::vector<double> pendingSharpness;
+            for (double t : pendingTimes) {
+                const int nearest = findNearestByTime(allSamples->value, t, videoInfo.duration);
+                pendingSharpness.push_back(nearest >= 0 ? allSamples->value[nearest].sharpness : 0.0);
+            }
+            ImPlot::PlotScatter("##pending", pendingTimes.data(), pendingSharpness.data(),
+                               static_cast<int>(pendingTimes.size()),
+                               ImPlotSpec(ImPlotProp_Marker, ImPlotMarker_Circle,
+                                          ImPlotProp_MarkerSize, 8.0f,
+                                          ImPlotProp_MarkerFillColor, ImVec4(0.0f, 0.0f, 0.0f, 0.0f),
+                                          ImPlotProp_LineWeight, 2.0f,
+                                          ImPlotProp_MarkerLineColor, ImVec4(0.3f, 0.9f, 0.4f, 0.6f)));
+        }
+
         // Visualize search window during analysis
         SearchState searchState = app.getSearchState();
         if (searchState.active) {
@@ -146,10 +243,7 @@ void renderTimelinePanel(App& app) {
             static double lastPreviewTime = -1.0;
             if (std::abs(hoveredTime - lastPreviewTime) > 0.05) {
                 lastPreviewTime = hoveredTime;
-                cv::Mat frame;
-                if (app.getAnalyzer().getFrameAt(hoveredTime, frame)) {
-                    app.setPreviewFrame(frame);
-                }
+                app.requestPreview(hoveredTime);
             }
 
             // Draw vertical indicator line at cursor
@@ -161,23 +255,13 @@ void renderTimelinePanel(App& app) {
             // Left-click: toggle selection on nearby marker
             if (ImGui::IsMouseClicked(ImGuiMouseButton_Left)) {
                 const double clickThreshold = videoInfo.duration * 0.01;  // 1% of duration
-                int closestIdx = -1;
-                double closestDist = clickThreshold;
-
-                for (int i = 0; i < static_cast<int>(selectedFrames.size()); i++) {
-                    double dist = std::abs(selectedFrames[i].time - hoveredTime);
-                    if (dist < closestDist) {
-                        closestDist = dist;
-                        closestIdx = i;
-                    }
-                }
-
+                const int closestIdx = findNearestByTime(selectedFrames, hoveredTime, clickThreshold);
                 if (closestIdx >= 0) {
-                    app.toggleFrameSelection(closestIdx);
+                    app.toggleFrameSelection(selectedFrames[closestIdx]);
                 }
             }
 
-            // Right-click: add new frame at this position
+            // Right-click: add the sharpest frame near this position
             if (ImGui::IsMouseClicked(ImGuiMouseButton_Right)) {
                 app.addFrameAtTime(hoveredTime);
             }
@@ -190,7 +274,11 @@ void renderTimelinePanel(App& app) {
 
     // Help text
     ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.52f, 1.0f),
-        "Left-click marker: toggle selection | Right-click: add frame | Scroll: zoom");
+        "Left-click marker: toggle selection | Right-click: add sharpest nearby frame | Scroll: zoom");
+    if (app.isRefining()) {
+        ImGui::SameLine();
+        ImGui::TextColored(ImVec4(0.26f, 0.75f, 0.75f, 1.0f), "| Refining curve...");
+    }
 
     ImGui::End();
 }
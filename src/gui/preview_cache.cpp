@@ -0,0 +1,96 @@
+#include "preview_cache.hpp"
+
+namespace sharpctl {
+
+void PreviewCache::makePreview(const cv::Mat& frame, cv::Mat& outPreview) {
+    cv::Mat scaled = frame;
+    if (frame.rows > kPreviewHeight) {
+        const int width = std::max(1, frame.cols * kPreviewHeight / frame.rows);
+        cv::resize(frame, scaled, cv::Size(width, kPreviewHeight), 0, 0, cv::INTER_AREA);
+    }
+
+    // Previews are for display only
+    if (scaled.depth() == CV_16U) {
+        scaled.convertTo(outPreview, CV_8U, 1.0 / 257.0);
+    } else {
+        outPreview = scaled;
+    }
+}
+
+bool PreviewCache::get(int frame, cv::Mat& outPreview, int variant) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(keyOf(frame, variant));
+    if (it == entries_.end()) {
+        misses_++;
+        return false;
+    }
+    lru_.splice(lru_.begin(), lru_, it->second);
+    outPreview = it->second->preview;
+    hits_++;
+    return true;
+}
+
+bool PreviewCache::contains(int frame, int variant) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.count(keyOf(frame, variant)) > 0;
+}
+
+bool PreviewCache::getLatestIn(int first, int frame, cv::Mat& outPreview, int& outFrame) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto best = lru_.end();
+    for (auto it = lru_.begin(); it != lru_.end(); ++it) {
+        if (it->frame >= first && it->frame <= frame && (best == lru_.end() || it->frame > best->frame)) {
+            best = it;
+        }
+    }
+    if (best == lru_.end()) return false;
+
+    outPreview = best->preview;
+    outFrame = best->frame;
+    return true;
+}
+
+void PreviewCache::put(int frame, const cv::Mat& preview, int variant) {
+    if (preview.empty()) return;
+
+    const long long key = keyOf(frame, variant);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto existing = entries_.find(key);
+    if (existing != entries_.end()) {
+        bytes_ -= existing->second->bytes();
+        lru_.erase(existing->second);
+        entries_.erase(existing);
+    }
+
+    lru_.push_front({frame, variant, preview});
+    entries_[key] = lru_.begin();
+    bytes_ += lru_.front().bytes();
+
+    while (bytes_ > budget_ && lru_.size() > 1) {
+        const Entry& oldest = lru_.back();
+        bytes_ -= oldest.bytes();
+        entries_.erase(keyOf(oldest.frame, oldest.variant));
+        lru_.pop_back();
+    }
+}
+
+void PreviewCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    entries_.clear();
+    bytes_ = 0;
+    hits_ = 0;
+    misses_ = 0;
+}
+
+PreviewCache::Stats PreviewCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats;
+    stats.entries = entries_.size();
+    stats.bytes = bytes_;
+    stats.hits = hits_;
+    stats.misses = misses_;
+    return stats;
+}
+
+}  // namespace sharpctl
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace sharpctl {
+
+// Recently decoded display frames by frame index and input, so scrubbing
+// back over a region does not decode it again (hover previews of at most
+// kPreviewHeight rows; also used for thumbnails). Frames of the scrub proxy
+// are kept apart from the original's, which they only stand in for. Bounded
+// by a byte budget, evicting the least recently used frames. Cached frames
+// are shared with whoever gets them and must not be written. Thread-safe.
+class PreviewCache {
+public:
+    static constexpr size_t kDefaultBudgetBytes = size_t(256) << 20;
+    static constexpr int kPreviewHeight = 720;
+
+    // Input a frame was decoded from
+    static constexpr int kOriginal = 0;
+    static constexpr int kProxy = 1;
+
+    struct Stats {
+        size_t entries = 0;
+        size_t bytes = 0;
+        size_t hits = 0;
+        size_t misses = 0;
+    };
+
+    explicit PreviewCache(size_t budgetBytes = kDefaultBudgetBytes) : budget_(budgetBytes) {}
+
+    // Shrink a decoded frame to preview size and depth
+    static void makePreview(const cv::Mat& frame, cv::Mat& outPreview);
+
+    // Share a cached frame into `outPreview`; false on a miss
+    bool get(int frame, cv::Mat& outPreview, int variant = kOriginal);
+    bool contains(int frame, int variant = kOriginal) const;
+
+    // Share the latest cached frame in [first, frame] of either input into
+    // `outPreview`, setting `outFrame` to its index; false if there is none.
+    // Not counted as a hit or miss.
+    bool getLatestIn(int first, int frame, cv::Mat& outPreview, int& outFrame);
+
+    // Store a preview (shared, not copied)
+    void put(int frame, const cv::Mat& preview, int variant = kOriginal);
+
+    void clear();
+    Stats getStats() const;
+
+private:
+    struct Entry {
+        int frame = 0;
+        int variant = kOriginal;
+        cv::Mat preview;
+
+        size_t bytes() const { return preview.total() * preview.elemSize(); }
+    };
+
+    static long long keyOf(int frame, int variant) { return (static_cast<long long>(frame) << 1) | variant; }
+
+    std::list<Entry> lru_;  // Most recently used first
+    std::unordered_map<long long, std::list<Entry>::iterator> entries_;
+    size_t budget_;
+    size_t bytes_ = 0;
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+    mutable std::mutex mutex_;
+};
+
+}  // namespace sharpctl
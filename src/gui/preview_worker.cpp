@@ -0,0 +1,275 @@
+#include "preview_worker.hpp"
+#include <algorithm>
+
+namespace sharpctl {
+
+PreviewWorker::PreviewWorker(VideoAnalyzer& analyzer) : analyzer_(analyzer) {}
+
+PreviewWorker::~PreviewWorker() {
+    stop();
+}
+
+void PreviewWorker::start(FrameCallback onFrame) {
+    stop();
+    onFrame_ = std::move(onFrame);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = false;
+        hasPending_ = false;
+    }
+    thread_ = std::thread([this]() { run(); });
+}
+
+void PreviewWorker::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void PreviewWorker::request(double timeSec) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pendingTime_ = timeSec;
+        if (!hasPending_) {
+            pendingSince_ = std::chrono::steady_clock::now();
+        }
+        hasPending_ = true;
+    }
+    wake_.notify_one();
+}
+
+void PreviewWorker::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    hasPending_ = false;
+    generation_++;
+    cache_.clear();
+}
+
+PreviewWorker::LatencyStats PreviewWorker::getLatencyStats() const {
+    std::lock_guard<std::mutex> lock(latencyMutex_);
+    LatencyStats stats;
+    stats.count = latencyCount_;
+    if (latencyCount_ == 0) return stats;
+
+    stats.lastMs = latencyMs_[(latencyNext_ + kLatencyWindow - 1) % kLatencyWindow];
+    double sum = 0.0;
+    for (size_t i = 0; i < latencyCount_; ++i) {
+        sum += latencyMs_[i];
+        stats.maxMs = std::max<double>(stats.maxMs, latencyMs_[i]);
+    }
+    stats.meanMs = sum / latencyCount_;
+    return stats;
+}
+
+void PreviewWorker::recordLatency(std::chrono::steady_clock::duration latency) {
+    std::lock_guard<std::mutex> lock(latencyMutex_);
+    latencyMs_[latencyNext_] = std::chrono::duration<float, std::milli>(latency).count();
+    latencyNext_ = (latencyNext_ + 1) % kLatencyWindow;
+    latencyCount_ = std::min(latencyCount_ + 1, kLatencyWindow);
+}
+
+bool PreviewWorker::ensureDecoder(uint64_t generation) {
+    // Reopen after a reset, and switch to the proxy once it is ready
+    if (decoderGeneration_ != generation) {
+        decoder_.reset();
+        originalDecoder_.reset();
+        lastFrame_ = -1;
+        prefetch_.clear();
+        exactFrame_ = -1;
+    }
+    if (!decoder_ || (!decoder_->isProxy() && analyzer_.hasProxy())) {
+        // The original's decoder stays on for exact frames
+        if (decoder_ && !originalDecoder_) {
+            originalDecoder_ = std::move(decoder_);
+        }
+        decoder_ = analyzer_.openDecoder(DecoderUse::Preview, true);
+        decoderGeneration_ = generation;
+    }
+    return decoder_ != nullptr;
+}
+
+DecoderHandle* PreviewWorker::exactDecoder() {
+    if (!decoder_->isProxy()) return decoder_.get();
+    if (!originalDecoder_) {
+        originalDecoder_ = analyzer_.openDecoder(DecoderUse::Preview);
+    }
+    return originalDecoder_.get();
+}
+
+bool PreviewWorker::decodePreview(DecoderHandle& decoder, int frame, uint64_t generation, cv::Mat& outPreview) {
+    cv::Mat decoded;
+    if (!decoder.getFrame(frame, decoded)) return false;
+    PreviewCache::makePreview(decoded, outPreview);
+
+    // Frames of a video that was replaced meanwhile must not enter the cache
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (generation != generation_) return false;
+    cache_.put(frame, outPreview, decoder.isProxy() ? PreviewCache::kProxy : PreviewCache::kOriginal);
+    return true;
+}
+
+void PreviewWorker::planPrefetch(int frame) {
+    prefetch_.clear();
+    if (lastFrame_ < 0 || frame == lastFrame_) return;
+
+    // Continue at the pace of the last move
+    const int step = frame - lastFrame_;
+    const int frameCount = decoder_->getInfo().frameCount;
+    for (int i = 1; i <= kPrefetchFrames; ++i) {
+        const long long next = frame + static_cast<long long>(step) * i;
+        if (next < 0 || next >= frameCount) break;
+        prefetch_.push_back(static_cast<int>(next));
+    }
+}
+
+int PreviewWorker::decodeDistance(int frame) const {
+    const int keyframe = decoder_->keyframeAtOrBefore(frame);
+    const int position = decoder_->getPosition();
+    if (position >= keyframe && position <= frame) {
+        return frame - position + 1;
+    }
+    return frame - keyframe + 1;
+}
+
+bool PreviewWorker::serveRequest(double timeSec, uint64_t generation) {
+    const int frame = decoder_->frameAtTime(timeSec);
+    planPrefetch(frame);
+    lastFrame_ = frame;
+    exactFrame_ = -1;
+
+    cv::Mat preview;
+    if (cache_.get(frame, preview)) {
+        if (onFrame_) onFrame_(preview, timeSec, true);
+        return true;
+    }
+
+    // The proxy is all-intra, so every frame of it is cheap; it stands in
+    // for the original until the cursor rests
+    if (decoder_->isProxy()) {
+        if (!cache_.get(frame, preview, PreviewCache::kProxy) &&
+            !decodePreview(*decoder_, frame, generation, preview)) {
+            return false;
+        }
+        exactFrame_ = frame;
+        exactTime_ = timeSec;
+        exactDeadline_ = std::chrono::steady_clock::now() + kRestDelay;
+        if (onFrame_) onFrame_(preview, timeSec, false);
+        return true;
+    }
+
+    if (decodeDistance(frame) <= kCheapDecodeFrames) {
+        if (!decodePreview(*decoder_, frame, generation, preview)) return false;
+        if (onFrame_) onFrame_(preview, timeSec, true);
+        return true;
+    }
+
+    exactFrame_ = frame;
+    exactTime_ = timeSec;
+    exactDeadline_ = std::chrono::steady_clock::now() + kRestDelay;
+
+    // Stand-in from the same GOP: the latest cached frame, else the keyframe
+    const int keyframe = decoder_->keyframeAtOrBefore(frame);
+    int shown = -1;
+    if (!cache_.getLatestIn(keyframe, frame, preview, shown) &&
+        !decodePreview(*decoder_, keyframe, generation, preview)) {
+        return false;
+    }
+    if (onFrame_) onFrame_(preview, timeSec, false);
+    return true;
+}
+
+void PreviewWorker::run() {
+    enum class Job { Request, Exact, Prefetch };
+
+    while (true) {
+        Job job;
+        double timeSec = 0.0;
+        std::chrono::steady_clock::time_point requestedAt;
+        uint64_t generation;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (true) {
+                if (stopping_) {
+                    lock.unlock();
+                    decoder_.reset();
+                    originalDecoder_.reset();
+                    return;
+                }
+                if (hasPending_) {
+                    job = Job::Request;
+                    timeSec = pendingTime_;
+                    requestedAt = pendingSince_;
+                    hasPending_ = false;
+                    break;
+                }
+                // The exact frame waits for the cursor to rest; prefetching waits for the exact frame
+                if (exactFrame_ >= 0) {
+                    if (std::chrono::steady_clock::now() >= exactDeadline_) {
+                        job = Job::Exact;
+                        break;
+                    }
+                    wake_.wait_until(lock, exactDeadline_);
+                    continue;
+                }
+                if (!prefetch_.empty()) {
+                    job = Job::Prefetch;
+                    break;
+                }
+                wake_.wait(lock);
+            }
+            generation = generation_;
+        }
+
+        // Background decoding waits while the user is waiting on this
+        InteractiveGate::Ticket ticket;
+        if (job != Job::Prefetch) {
+            ticket = analyzer_.interactiveGate().enter();
+        }
+
+        if (!ensureDecoder(generation)) {
+            prefetch_.clear();
+            exactFrame_ = -1;
+            continue;
+        }
+
+        switch (job) {
+            case Job::Request:
+                if (serveRequest(timeSec, generation)) {
+                    recordLatency(std::chrono::steady_clock::now() - requestedAt);
+                }
+                break;
+
+            case Job::Exact: {
+                const int frame = exactFrame_;
+                exactFrame_ = -1;
+                if (frame < 0) break;
+                DecoderHandle* decoder = exactDecoder();
+                cv::Mat preview;
+                if (decoder && decodePreview(*decoder, frame, generation, preview) && onFrame_) {
+                    onFrame_(preview, exactTime_, true);
+                }
+                break;
+            }
+
+            case Job::Prefetch: {
+                // Idle: decode the next frame the cursor is heading for
+                if (prefetch_.empty()) break;
+                const int frame = prefetch_.front();
+                prefetch_.pop_front();
+                const int variant = decoder_->isProxy() ? PreviewCache::kProxy : PreviewCache::kOriginal;
+                cv::Mat preview;
+                if (!cache_.contains(frame, variant)) {
+                    decodePreview(*decoder_, frame, generation, preview);
+                }
+                break;
+            }
+        }
+    }
+}
+
+}  // namespace sharpctl
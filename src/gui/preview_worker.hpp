@@ -0,0 +1,129 @@
+#pragma once
+
+#include "core/video_analyzer.hpp"
+#include "preview_cache.hpp"
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace sharpctl {
+
+// Decodes hover previews on a background thread with its own decoder, so the
+// UI never waits on a seek. Requests go through a single-slot mailbox: a new
+// request replaces one that has not started yet, so while the mouse moves
+// only the newest position is decoded. Decoded previews are cached, and when
+// idle the worker decodes a few frames ahead in the direction the cursor
+// last moved.
+//
+// Where the exact frame is expensive (deep into a long GOP), a request is
+// answered in two steps: first with the closest frame that is cheap to get
+// (a cached frame of the same GOP, or its keyframe), then with the exact
+// frame once the cursor has rested for kRestDelay. With a scrub proxy, the
+// proxy frame is the stand-in and the exact frame comes from the original.
+//
+// Requests and exact frames are interactive work: while one is decoded,
+// analysis and other background decoding wait (see InteractiveGate).
+// Prefetching is not.
+class PreviewWorker {
+public:
+    static constexpr int kPrefetchFrames = 6;
+    static constexpr int kCheapDecodeFrames = 3;  // Exact frames this close are decoded at once
+    static constexpr std::chrono::milliseconds kRestDelay{120};
+    static constexpr size_t kLatencyWindow = 64;
+
+    // Time from request() to the first frame shown for it, over the last
+    // kLatencyWindow answered requests
+    struct LatencyStats {
+        size_t count = 0;
+        double lastMs = 0.0;
+        double meanMs = 0.0;
+        double maxMs = 0.0;
+    };
+
+    // Called on the worker thread with the preview frame (shared with the
+    // cache, so read-only) and whether it is the exact frame for `timeSec`;
+    // may take the buffer
+    using FrameCallback = std::function<void(cv::Mat& frame, double timeSec, bool exact)>;
+
+    explicit PreviewWorker(VideoAnalyzer& analyzer);
+    ~PreviewWorker();
+
+    PreviewWorker(const PreviewWorker&) = delete;
+    PreviewWorker& operator=(const PreviewWorker&) = delete;
+
+    void start(FrameCallback onFrame);
+    void stop();
+
+    // Ask for the frame at `timeSec`, replacing any pending request
+    void request(double timeSec);
+
+    // Drop the decoder, cache and pending work, e.g. after another video was
+    // opened. A frame decoded before the reset is not delivered.
+    void reset();
+
+    PreviewCache::Stats getCacheStats() const { return cache_.getStats(); }
+    LatencyStats getLatencyStats() const;
+
+private:
+    void run();
+
+    // Open or reopen the decoder as needed for `generation`
+    bool ensureDecoder(uint64_t generation);
+
+    // Decoder of the original for exact frames: decoder_ unless that reads
+    // the proxy. Null if it cannot be opened.
+    DecoderHandle* exactDecoder();
+
+    // Decode `frame` with `decoder` into the cache and return its preview;
+    // false if it failed or a reset since `generation` made it stale
+    bool decodePreview(DecoderHandle& decoder, int frame, uint64_t generation, cv::Mat& outPreview);
+
+    // Queue frames ahead of `frame` in the direction of the last move
+    void planPrefetch(int frame);
+
+    // Frames to decode to reach `frame` from the decoder's position
+    int decodeDistance(int frame) const;
+
+    // Answer a request: exact if cheap, else a stand-in now and the exact
+    // frame after the rest delay. True if a frame was shown.
+    bool serveRequest(double timeSec, uint64_t generation);
+
+    void recordLatency(std::chrono::steady_clock::duration latency);
+
+    VideoAnalyzer& analyzer_;
+    FrameCallback onFrame_;
+    PreviewCache cache_;
+    std::thread thread_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    double pendingTime_ = 0.0;
+    std::chrono::steady_clock::time_point pendingSince_;
+    bool hasPending_ = false;
+    bool stopping_ = false;
+    uint64_t generation_ = 0;  // Bumped by reset()
+
+    // Worker thread only
+    std::unique_ptr<DecoderHandle> decoder_;  // The proxy once it is ready
+    std::unique_ptr<DecoderHandle> originalDecoder_;  // Exact frames while decoder_ reads the proxy
+    uint64_t decoderGeneration_ = 0;
+    int lastFrame_ = -1;
+    std::deque<int> prefetch_;
+    int exactFrame_ = -1;  // Exact frame owed for the last request, -1 if none
+    double exactTime_ = 0.0;
+    std::chrono::steady_clock::time_point exactDeadline_;
+
+    // Latency ring buffer
+    std::array<float, kLatencyWindow> latencyMs_{};
+    size_t latencyCount_ = 0;
+    size_t latencyNext_ = 0;
+    mutable std::mutex latencyMutex_;
+};
+
+}  // namespace sharpctl
@@ -0,0 +1,108 @@
+#include "refine_worker.hpp"
+
+namespace sharpctl {
+
+RefineWorker::RefineWorker(VideoAnalyzer& analyzer) : analyzer_(analyzer) {}
+
+RefineWorker::~RefineWorker() {
+    stop();
+}
+
+void RefineWorker::start(SamplesCallback onSamples) {
+    stop();
+    onSamples_ = std::move(onSamples);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = false;
+        hasPending_ = false;
+    }
+    thread_ = std::thread([this]() { run(); });
+}
+
+void RefineWorker::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        generation_++;
+    }
+    wake_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void RefineWorker::request(const AnalysisParams& params, std::vector<int> frames) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pendingParams_ = params;
+        pendingFrames_ = std::move(frames);
+        pendingSince_ = std::chrono::steady_clock::now();
+        hasPending_ = true;
+        generation_++;
+        busy_.store(true);
+    }
+    wake_.notify_one();
+}
+
+void RefineWorker::reset() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    hasPending_ = false;
+    generation_++;
+    idle_.wait(lock, [this]() { return !running_; });
+    busy_.store(false);
+}
+
+void RefineWorker::run() {
+    while (true) {
+        AnalysisParams params;
+        std::vector<int> frames;
+        uint64_t generation;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (true) {
+                if (stopping_) return;
+                if (hasPending_) {
+                    // Wait for the view to settle; a newer request restarts the wait
+                    const auto due = pendingSince_ + kSettleDelay;
+                    if (std::chrono::steady_clock::now() >= due) break;
+                    wake_.wait_until(lock, due);
+                    continue;
+                }
+                busy_.store(false);
+                wake_.wait(lock);
+            }
+            params = pendingParams_;
+            frames.swap(pendingFrames_);
+            hasPending_ = false;
+            generation = generation_;
+            running_ = true;
+        }
+
+        auto isCurrent = [&]() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return generation == generation_;
+        };
+
+        std::vector<FrameData> batch;
+        analyzer_.scoreFrames(params, frames, [&](const FrameData& sample) {
+            batch.push_back(sample);
+            if (batch.size() >= kBatchFrames) {
+                if (!isCurrent()) return false;
+                if (onSamples_) onSamples_(batch);
+                batch.clear();
+            }
+            return isCurrent();
+        });
+        if (!batch.empty() && isCurrent() && onSamples_) {
+            onSamples_(batch);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            running_ = false;
+        }
+        idle_.notify_all();
+    }
+}
+
+}  // namespace sharpctl
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "core/video_analyzer.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sharpctl {
+
+// Scores extra curve samples in the range the timeline is zoomed into, on a
+// background thread, so detail is spent only where the user is looking.
+// Only the latest range is kept: it starts once the view has stayed put for
+// kSettleDelay, and a newer range stops the one in progress at its next
+// frame. Samples arrive in small batches so the curve fills in as it goes.
+class RefineWorker {
+public:
+    static constexpr std::chrono::milliseconds kSettleDelay{250};
+    static constexpr size_t kBatchFrames = 16;
+
+    // Called on the worker thread with new samples in time order; may take them
+    using SamplesCallback = std::function<void(std::vector<FrameData>& samples)>;
+
+    explicit RefineWorker(VideoAnalyzer& analyzer);
+    ~RefineWorker();
+
+    RefineWorker(const RefineWorker&) = delete;
+    RefineWorker& operator=(const RefineWorker&) = delete;
+
+    void start(SamplesCallback onSamples);
+    void stop();
+
+    // Score `frames` (ascending) as the curve was scored with `params`,
+    // replacing any pending or running range
+    void request(const AnalysisParams& params, std::vector<int> frames);
+
+    // Drop pending work and wait until a running range has stopped, e.g.
+    // before a pass starts or another video is opened
+    void reset();
+
+    bool isBusy() const { return busy_.load(); }
+
+private:
+    void run();
+
+    VideoAnalyzer& analyzer_;
+    SamplesCallback onSamples_;
+    std::thread thread_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    AnalysisParams pendingParams_;
+    std::vector<int> pendingFrames_;
+    bool hasPending_ = false;
+    std::chrono::steady_clock::time_point pendingSince_;
+    bool running_ = false;  // A range is being scored
+    bool stopping_ = false;
+    uint64_t generation_ = 0;  // Bumped by request() and reset()
+    std::atomic<bool> busy_{false};
+};
+
+}  // namespace sharpctl
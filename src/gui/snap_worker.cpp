@@ -0,0 +1,105 @@
+#include "snap_worker.hpp"
+#include <algorithm>
+
+namespace sharpctl {
+
+SnapWorker::SnapWorker(VideoAnalyzer& analyzer) : analyzer_(analyzer) {}
+
+SnapWorker::~SnapWorker() {
+    stop();
+}
+
+void SnapWorker::start(FrameCallback onFrame) {
+    stop();
+    onFrame_ = std::move(onFrame);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = false;
+        queue_.clear();
+        pending_.clear();
+    }
+    thread_ = std::thread([this]() { run(); });
+}
+
+void SnapWorker::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void SnapWorker::request(Job job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.push_back(job.time);
+        queue_.push_back(std::move(job));
+    }
+    wake_.notify_one();
+}
+
+std::vector<double> SnapWorker::getPending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_;
+}
+
+void SnapWorker::reset() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    queue_.clear();
+    pending_.clear();
+    generation_++;
+    idle_.wait(lock, [this]() { return !running_; });
+}
+
+void SnapWorker::run() {
+    while (true) {
+        Job job;
+        uint64_t generation;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+            if (stopping_) break;
+            job = std::move(queue_.front());
+            queue_.pop_front();
+            generation = generation_;
+            running_ = true;
+        }
+
+        FrameData frame;
+        bool found = false;
+        {
+            // A click is interactive: background decoding waits for it
+            InteractiveGate::Ticket ticket = analyzer_.interactiveGate().enter();
+
+            // Reopen after a reset; snapping always decodes the original
+            if (!decoder_ || decoderGeneration_ != generation) {
+                decoder_ = analyzer_.openDecoder(DecoderUse::Manual);
+                decoderGeneration_ = generation;
+            }
+            found = decoder_ && analyzer_.findSharpestNear(*decoder_, job.params, job.time,
+                                                           job.params.snapWindowSec, job.known, frame);
+        }
+
+        // Deliver and unmark together, unless a reset came in meanwhile
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (generation == generation_) {
+                if (found && onFrame_) {
+                    onFrame_(frame);
+                }
+                auto it = std::find(pending_.begin(), pending_.end(), job.time);
+                if (it != pending_.end()) {
+                    pending_.erase(it);
+                }
+            }
+            running_ = false;
+        }
+        idle_.notify_all();
+    }
+    decoder_.reset();
+}
+
+}  // namespace sharpctl
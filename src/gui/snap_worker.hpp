@@ -0,0 +1,71 @@
+#pragma once
+
+#include "core/video_analyzer.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace sharpctl {
+
+// Adds frames by hand off the UI thread: each click is snapped to the
+// sharpest frame within AnalysisParams::snapWindowSec of it, decoded on the
+// worker's own handle ahead of any background decoding. Clicks are served in
+// order and stay listed in getPending() until their frame has been delivered,
+// so the timeline can mark them right away.
+class SnapWorker {
+public:
+    struct Job {
+        double time = 0.0;
+        AnalysisParams params;
+        std::unordered_map<int, double> known;  // Frame scores the curve already has
+    };
+
+    // Called on the worker thread with the frame picked for a click
+    using FrameCallback = std::function<void(FrameData& frame)>;
+
+    explicit SnapWorker(VideoAnalyzer& analyzer);
+    ~SnapWorker();
+
+    SnapWorker(const SnapWorker&) = delete;
+    SnapWorker& operator=(const SnapWorker&) = delete;
+
+    void start(FrameCallback onFrame);
+    void stop();
+
+    void request(Job job);
+
+    // Click times still being snapped, oldest first
+    std::vector<double> getPending() const;
+
+    // Drop queued clicks and wait for the one in progress, e.g. after another
+    // video is opened
+    void reset();
+
+private:
+    void run();
+
+    VideoAnalyzer& analyzer_;
+    FrameCallback onFrame_;
+    std::thread thread_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    std::deque<Job> queue_;
+    std::vector<double> pending_;
+    bool running_ = false;  // A click is being snapped
+    bool stopping_ = false;
+    uint64_t generation_ = 0;  // Bumped by reset()
+
+    // Worker thread only
+    std::unique_ptr<DecoderHandle> decoder_;
+    uint64_t decoderGeneration_ = 0;
+};
+
+}  // namespace sharpctl
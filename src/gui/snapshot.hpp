@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace sharpctl {
+
+// Immutable value published at a given version
+template <typename T>
+struct Snapshot {
+    uint64_t version = 0;
+    T value{};
+};
+
+// Single-value RCU: readers take the current snapshot and keep it alive for
+// as long as they hold the pointer; writers build a new value and swap it
+// in. The pointer itself is guarded by a mutex held only to copy or replace
+// it (std::atomic<std::shared_ptr> needs GCC 12's libstdc++), so readers
+// never wait on a writer building its value, and the render loop can look
+// at the data every frame without copying it, rebuilding derived state only
+// when the version changes. Writers are serialized among themselves.
+template <typename T>
+class Published {
+public:
+    using Ptr = std::shared_ptr<const Snapshot<T>>;
+
+    Published() : current_(std::make_shared<const Snapshot<T>>()) {}
+
+    Ptr load() const {
+        std::lock_guard<std::mutex> lock(pointerMutex_);
+        return current_;
+    }
+
+    // Replace the value
+    void publish(T value) {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        store(std::move(value));
+    }
+
+    // Copy the current value, modify the copy with `fn(T&)` and publish it
+    template <typename Fn>
+    void update(Fn&& fn) {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        T value = load()->value;
+        fn(value);
+        store(std::move(value));
+    }
+
+private:
+    void store(T value) {
+        auto next = std::make_shared<Snapshot<T>>();
+        next->version = load()->version + 1;
+        next->value = std::move(value);
+
+        // The old snapshot is released outside the lock
+        Ptr previous = std::move(next);
+        {
+            std::lock_guard<std::mutex> lock(pointerMutex_);
+            current_.swap(previous);
+        }
+    }
+
+    Ptr current_;
+    mutable std::mutex pointerMutex_;
+    std::mutex writeMutex_;
+};
+
+}  // namespace sharpctl
@@ -0,0 +1,123 @@
+#include "thumbnail_worker.hpp"
+#include <algorithm>
+
+namespace sharpctl {
+
+namespace {
+
+// Prefetching stops here so it never evicts thumbnails already on screen
+constexpr size_t kPrefetchBudgetBytes = ThumbnailWorker::kBudgetBytes * 3 / 4;
+
+}  // anonymous namespace
+
+ThumbnailWorker::ThumbnailWorker(VideoAnalyzer& analyzer) : analyzer_(analyzer) {}
+
+ThumbnailWorker::~ThumbnailWorker() {
+    stop();
+}
+
+void ThumbnailWorker::start(std::function<void()> onReady) {
+    stop();
+    onReady_ = std::move(onReady);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = false;
+        queue_.clear();
+        prefetch_.clear();
+    }
+    thread_ = std::thread([this]() { run(); });
+}
+
+void ThumbnailWorker::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+bool ThumbnailWorker::get(int frame, cv::Mat& outThumbnail) {
+    if (thumbnails_.get(frame, outThumbnail)) return true;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto queued = std::find(queue_.begin(), queue_.end(), frame);
+        if (queued != queue_.end()) {
+            queue_.erase(queued);
+        }
+        queue_.push_front(frame);
+        if (queue_.size() > kMaxQueued) {
+            queue_.pop_back();
+        }
+    }
+    wake_.notify_one();
+    return false;
+}
+
+void ThumbnailWorker::prefetch(std::vector<int> frames) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        prefetch_.assign(frames.begin(), frames.end());
+    }
+    wake_.notify_one();
+}
+
+void ThumbnailWorker::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.clear();
+    prefetch_.clear();
+    generation_++;
+    thumbnails_.clear();
+}
+
+void ThumbnailWorker::run() {
+    while (true) {
+        int frame;
+        uint64_t generation;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this]() { return stopping_ || !queue_.empty() || !prefetch_.empty(); });
+            if (stopping_) break;
+            if (!queue_.empty()) {
+                frame = queue_.front();
+                queue_.pop_front();
+            } else if (thumbnails_.getStats().bytes < kPrefetchBudgetBytes) {
+                frame = prefetch_.front();
+                prefetch_.pop_front();
+            } else {
+                prefetch_.clear();
+                continue;
+            }
+            generation = generation_;
+        }
+        if (thumbnails_.contains(frame)) continue;
+
+        // Reopen after a reset, and switch to the proxy once it is ready
+        if (!decoder_ || decoderGeneration_ != generation || (!decoder_->isProxy() && analyzer_.hasProxy())) {
+            decoder_ = analyzer_.openDecoder(DecoderUse::Thumbnail, true);
+            decoderGeneration_ = generation;
+        }
+
+        // Thumbnails are background work; hover previews go first
+        analyzer_.interactiveGate().yield();
+
+        cv::Mat decoded, thumbnail;
+        if (!decoder_ || !decoder_->getFrame(frame, decoded)) continue;
+        VideoAnalyzer::makeThumbnail(decoded, thumbnail);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (generation != generation_) continue;
+            thumbnails_.put(frame, thumbnail);
+        }
+        if (onReady_) {
+            onReady_();
+        }
+    }
+    decoder_.reset();
+}
+
+}  // namespace sharpctl
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "core/video_analyzer.hpp"
+#include "preview_cache.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sharpctl {
+
+// Generates thumbnails of frames on demand on a background thread, with its
+// own decoder (the scrub proxy when one is ready). Requests are served newest
+// first and only the most recent few are kept, so frames that scrolled out of
+// view before their turn are never decoded. Prefetched frames fill in behind
+// them while the worker is otherwise idle.
+class ThumbnailWorker {
+public:
+    static constexpr size_t kMaxQueued = 64;
+    static constexpr size_t kBudgetBytes = size_t(64) << 20;
+
+    explicit ThumbnailWorker(VideoAnalyzer& analyzer);
+    ~ThumbnailWorker();
+
+    ThumbnailWorker(const ThumbnailWorker&) = delete;
+    ThumbnailWorker& operator=(const ThumbnailWorker&) = delete;
+
+    // `onReady` is called from the worker thread after each new thumbnail
+    void start(std::function<void()> onReady = nullptr);
+    void stop();
+
+    // Get the thumbnail of `frame` (shared, read-only) if it was generated;
+    // otherwise queue it and return false
+    bool get(int frame, cv::Mat& outThumbnail);
+
+    // Generate thumbnails of `frames` in the given order whenever no request
+    // is waiting, until the cache is mostly full. Replaces earlier prefetches.
+    void prefetch(std::vector<int> frames);
+
+    // Drop generated thumbnails and queued requests, e.g. after another video
+    // was opened
+    void reset();
+
+private:
+    void run();
+
+    VideoAnalyzer& analyzer_;
+    std::function<void()> onReady_;
+    PreviewCache thumbnails_{kBudgetBytes};
+    std::thread thread_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<int> queue_;  // Newest first
+    std::deque<int> prefetch_;
+    bool stopping_ = false;
+    uint64_t generation_ = 0;  // Bumped by reset()
+
+    // Worker thread only
+    std::unique_ptr<DecoderHandle> decoder_;
+    uint64_t decoderGeneration_ = 0;
+};
+
+}  // namespace sharpctl
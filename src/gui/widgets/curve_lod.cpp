@@ -0,0 +1,96 @@
+#include "curve_lod.hpp"
+#include <algorithm>
+
+namespace sharpctl::gui {
+
+void CurveLod::clear() {
+    x_.clear();
+    y_.clear();
+    levels_.clear();
+    maxY_ = 0.0;
+}
+
+void CurveLod::append(double x, double y) {
+    x_.push_back(x);
+    y_.push_back(y);
+    maxY_ = x_.size() == 1 ? y : std::max(maxY_, y);
+
+    // Every completed pair of points (or of buckets) completes a bucket one level up
+    const size_t n = x_.size();
+    if (n % 2 != 0) return;
+
+    const bool lowFirst = y_[n - 2] <= y_[n - 1];
+    Bucket bucket{lowFirst ? x_[n - 2] : x_[n - 1], std::min(y_[n - 2], y_[n - 1]),
+                  lowFirst ? x_[n - 1] : x_[n - 2], std::max(y_[n - 2], y_[n - 1])};
+
+    for (size_t level = 0;; ++level) {
+        if (levels_.size() <= level) levels_.emplace_back();
+        std::vector<Bucket>& buckets = levels_[level];
+        buckets.push_back(bucket);
+        if (buckets.size() % 2 != 0) break;
+
+        const Bucket& a = buckets[buckets.size() - 2];
+        const Bucket& b = buckets[buckets.size() - 1];
+        const Bucket& low = a.yMin <= b.yMin ? a : b;
+        const Bucket& high = a.yMax >= b.yMax ? a : b;
+        bucket = {low.xMin, low.yMin, high.xMax, high.yMax};
+    }
+}
+
+void CurveLod::decimate(double xMin, double xMax, int maxPoints,
+                        std::vector<double>& outX, std::vector<double>& outY) const {
+    outX.clear();
+    outY.clear();
+    if (x_.empty()) return;
+
+    // Visible points plus one neighbour on each side
+    size_t lo = static_cast<size_t>(std::lower_bound(x_.begin(), x_.end(), xMin) - x_.begin());
+    size_t hi = static_cast<size_t>(std::upper_bound(x_.begin(), x_.end(), xMax) - x_.begin());
+    lo = lo > 0 ? lo - 1 : 0;
+    hi = std::min(hi + 1, x_.size());
+    if (lo >= hi) return;
+
+    // Coarsest detail needed: each bucket draws as two points
+    const size_t count = hi - lo;
+    const size_t budget = static_cast<size_t>(std::max(maxPoints, 2));
+    size_t level = 0;
+    while (level < levels_.size() && count > budget * spanOf(level) / 2) {
+        level++;
+    }
+    if (count <= budget || levels_.empty()) {
+        outX.assign(x_.begin() + lo, x_.begin() + hi);
+        outY.assign(y_.begin() + lo, y_.begin() + hi);
+        return;
+    }
+    level = std::min(level, levels_.size() - 1);
+
+    outX.reserve(2 * count / spanOf(level) + 2 * levels_.size());
+    outY.reserve(outX.capacity());
+
+    // Walk the range in buckets, dropping to finer levels for the incomplete tail
+    size_t pos = lo / spanOf(level) * spanOf(level);
+    while (pos < hi) {
+        size_t l = level + 1;
+        while (l > 0 && (pos % spanOf(l - 1) != 0 || pos / spanOf(l - 1) >= levels_[l - 1].size())) {
+            l--;
+        }
+        if (l == 0) {
+            outX.push_back(x_[pos]);
+            outY.push_back(y_[pos]);
+            pos++;
+            continue;
+        }
+
+        const Bucket& bucket = levels_[l - 1][pos / spanOf(l - 1)];
+        if (bucket.xMin <= bucket.xMax) {
+            outX.insert(outX.end(), {bucket.xMin, bucket.xMax});
+            outY.insert(outY.end(), {bucket.yMin, bucket.yMax});
+        } else {
+            outX.insert(outX.end(), {bucket.xMax, bucket.xMin});
+            outY.insert(outY.end(), {bucket.yMax, bucket.yMin});
+        }
+        pos += spanOf(l - 1);
+    }
+}
+
+}  // namespace sharpctl::gui
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace sharpctl::gui {
+
+// Min/max pyramid over a curve with ascending x, for drawing long curves at
+// a bounded cost. Level k summarizes runs of 2^(k+1) points by their minimum
+// and maximum, so a decimated curve still shows every peak and dip. Points
+// are appended one at a time; the pyramid grows with them.
+class CurveLod {
+public:
+    void clear();
+
+    // Add a point; x must not be smaller than the previous one
+    void append(double x, double y);
+
+    size_t size() const { return x_.size(); }
+    double getMaxY() const { return maxY_; }
+
+    // Points to draw for x in [xMin, xMax], about `maxPoints` of them. Raw
+    // points are returned when few enough are visible; one point on either
+    // side of the range is included so the line reaches the plot edges.
+    void decimate(double xMin, double xMax, int maxPoints,
+                  std::vector<double>& outX, std::vector<double>& outY) const;
+
+private:
+    // Extrema of a run of points, with where they occur
+    struct Bucket {
+        double xMin, yMin;
+        double xMax, yMax;
+    };
+
+    static size_t spanOf(size_t level) { return size_t(2) << level; }
+
+    std::vector<double> x_, y_;
+    std::vector<std::vector<Bucket>> levels_;
+    double maxY_ = 0.0;
+};
+
+}  // namespace sharpctl::gui
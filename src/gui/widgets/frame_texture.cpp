@@ -1,12 +1,20 @@
+// Pixel buffer objects are core since OpenGL 2.1; take their prototypes from glext.h
+#define GL_GLEXT_PROTOTYPES
 #include "frame_texture.hpp"
+#include <GL/glext.h>
+#include <cstring>
 
 namespace sharpctl::gui {
 
 FrameTexture::FrameTexture() {
     glGenTextures(1, &textureID_);
+    glGenBuffers(2, pixelBuffers_);
 }
 
 FrameTexture::~FrameTexture() {
+    if (pixelBuffers_[0] != 0) {
+        glDeleteBuffers(2, pixelBuffers_);
+    }
     if (textureID_ != 0) {
         glDeleteTextures(1, &textureID_);
     }
@@ -18,30 +26,73 @@ void FrameTexture::upload(const cv::Mat& frame) {
         return;
     }
 
-    // Convert BGR to RGB
-    cv::Mat rgb;
-    if (frame.channels() == 3) {
-        cv::cvtColor(frame, rgb, cv::COLOR_BGR2RGB);
-    } else if (frame.channels() == 4) {
-        cv::cvtColor(frame, rgb, cv::COLOR_BGRA2RGB);
-    } else {
-        cv::cvtColor(frame, rgb, cv::COLOR_GRAY2RGB);
+    GLenum format;
+    switch (frame.channels()) {
+        case 1: format = GL_RED; break;
+        case 3: format = GL_BGR; break;
+        case 4: format = GL_BGRA; break;
+        default: return;
     }
 
-    width_ = rgb.cols;
-    height_ = rgb.rows;
+    GLenum type;
+    switch (frame.depth()) {
+        case CV_8U: type = GL_UNSIGNED_BYTE; break;
+        case CV_16U: type = GL_UNSIGNED_SHORT; break;  // Full-range 16-bit, normalized by the GPU
+        default: return;
+    }
+
+    width_ = frame.cols;
+    height_ = frame.rows;
 
     glBindTexture(GL_TEXTURE_2D, textureID_);
 
-    // Set texture parameters
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    // Allocate storage only when the size changes
+    if (width_ != storageWidth_ || height_ != storageHeight_) {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, width_, height_, 0, format, type, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        storageWidth_ = width_;
+        storageHeight_ = height_;
+    }
 
-    // Upload texture data
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width_, height_, 0,
-                 GL_RGB, GL_UNSIGNED_BYTE, rgb.data);
+    // Gray frames are stored in the red channel
+    const GLint graySwizzle[4] = {GL_RED, GL_RED, GL_RED, GL_ONE};
+    const GLint colorSwizzle[4] = {GL_RED, GL_GREEN, GL_BLUE, GL_ONE};
+    glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, format == GL_RED ? graySwizzle : colorSwizzle);
+
+    // Stage the pixels in the next pixel buffer. Reallocating it first lets
+    // the driver hand out fresh memory instead of waiting for the GPU to
+    // finish reading the previous upload from it.
+    const size_t rowBytes = frame.cols * frame.elemSize();
+    const size_t bytes = rowBytes * frame.rows;
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffers_[nextBuffer_]);
+    nextBuffer_ ^= 1;
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(bytes), nullptr, GL_STREAM_DRAW);
+    auto* staging = static_cast<uchar*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(bytes),
+                                                         GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    if (staging) {
+        if (frame.isContinuous()) {
+            std::memcpy(staging, frame.data, bytes);
+        } else {
+            for (int r = 0; r < frame.rows; ++r) {
+                std::memcpy(staging + r * rowBytes, frame.ptr(r), rowBytes);
+            }
+        }
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width_, height_, format, type, nullptr);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    } else {
+        // Mapping failed: upload straight from the frame
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(frame.step[0] / frame.elemSize()));
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width_, height_, format, type, frame.data);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 
     glBindTexture(GL_TEXTURE_2D, 0);
 }
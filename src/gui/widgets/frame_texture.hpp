@@ -10,7 +10,10 @@ public:
     FrameTexture();
     ~FrameTexture();
 
-    // Upload a cv::Mat to GPU texture
+    // Upload a cv::Mat to GPU texture. BGR, BGRA and gray frames of 8 or 16
+    // bits go up as they are (the GPU swizzles and normalizes); storage is
+    // only reallocated when the size changes. Pixels are staged through two
+    // alternating pixel buffers, so the transfer overlaps with rendering.
     void upload(const cv::Mat& frame);
 
     // Clear the texture
@@ -28,8 +31,12 @@ public:
 
 private:
     GLuint textureID_ = 0;
+    GLuint pixelBuffers_[2] = {0, 0};
+    int nextBuffer_ = 0;
     int width_ = 0;
     int height_ = 0;
+    int storageWidth_ = 0;   // Size of the allocated texture storage
+    int storageHeight_ = 0;
 };
 
 }  // namespace sharpctl::gui
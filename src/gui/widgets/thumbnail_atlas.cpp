@@ -0,0 +1,103 @@
+#include "thumbnail_atlas.hpp"
+#include <algorithm>
+
+namespace sharpctl::gui {
+
+namespace {
+
+constexpr int kColumns = ThumbnailAtlas::kAtlasWidth / ThumbnailAtlas::kCellWidth;
+constexpr int kRows = ThumbnailAtlas::kAtlasHeight / ThumbnailAtlas::kCellHeight;
+
+}  // anonymous namespace
+
+ThumbnailAtlas::ThumbnailAtlas() : cells_(kColumns * kRows) {
+    glGenTextures(1, &textureID_);
+    glBindTexture(GL_TEXTURE_2D, textureID_);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, kAtlasWidth, kAtlasHeight, 0, GL_BGR, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+ThumbnailAtlas::~ThumbnailAtlas() {
+    if (textureID_ != 0) {
+        glDeleteTextures(1, &textureID_);
+    }
+}
+
+bool ThumbnailAtlas::find(int key, Slot& outSlot) {
+    auto it = cellOfKey_.find(key);
+    if (it == cellOfKey_.end()) return false;
+
+    cells_[it->second].lastUse = ++useClock_;
+    outSlot = slotOf(it->second);
+    return true;
+}
+
+void ThumbnailAtlas::add(int key, const cv::Mat& thumbnail) {
+    if (thumbnail.empty() || thumbnail.depth() != CV_8U) return;
+
+    // Reuse the key's cell, else the least recently used one
+    size_t cell;
+    auto existing = cellOfKey_.find(key);
+    if (existing != cellOfKey_.end()) {
+        cell = existing->second;
+    } else {
+        cell = static_cast<size_t>(std::min_element(cells_.begin(), cells_.end(),
+            [](const Cell& a, const Cell& b) { return a.lastUse < b.lastUse; }) - cells_.begin());
+        if (cells_[cell].key >= 0) {
+            cellOfKey_.erase(cells_[cell].key);
+        }
+    }
+
+    cv::Mat fitted = thumbnail;
+    if (thumbnail.cols > kCellWidth || thumbnail.rows > kCellHeight) {
+        const double scale = std::min(static_cast<double>(kCellWidth) / thumbnail.cols,
+                                      static_cast<double>(kCellHeight) / thumbnail.rows);
+        cv::resize(thumbnail, fitted, cv::Size(), scale, scale, cv::INTER_AREA);
+    }
+    if (fitted.channels() == 1) {
+        cv::cvtColor(fitted, fitted, cv::COLOR_GRAY2BGR);
+    } else if (fitted.channels() == 4) {
+        cv::cvtColor(fitted, fitted, cv::COLOR_BGRA2BGR);
+    }
+
+    const int x = static_cast<int>(cell % kColumns) * kCellWidth;
+    const int y = static_cast<int>(cell / kColumns) * kCellHeight;
+    glBindTexture(GL_TEXTURE_2D, textureID_);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(fitted.step[0] / fitted.elemSize()));
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, fitted.cols, fitted.rows, GL_BGR, GL_UNSIGNED_BYTE, fitted.data);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    cells_[cell] = {key, ++useClock_, fitted.cols, fitted.rows};
+    cellOfKey_[key] = cell;
+}
+
+void ThumbnailAtlas::clear() {
+    std::fill(cells_.begin(), cells_.end(), Cell{});
+    cellOfKey_.clear();
+    useClock_ = 0;
+}
+
+ThumbnailAtlas::Slot ThumbnailAtlas::slotOf(size_t cell) const {
+    const Cell& c = cells_[cell];
+    const float x = static_cast<float>(cell % kColumns) * kCellWidth;
+    const float y = static_cast<float>(cell / kColumns) * kCellHeight;
+
+    // Half a texel inside the thumbnail, so filtering never reads a neighbour
+    Slot slot;
+    slot.u0 = (x + 0.5f) / kAtlasWidth;
+    slot.v0 = (y + 0.5f) / kAtlasHeight;
+    slot.u1 = (x + c.width - 0.5f) / kAtlasWidth;
+    slot.v1 = (y + c.height - 0.5f) / kAtlasHeight;
+    slot.width = c.width;
+    slot.height = c.height;
+    return slot;
+}
+
+}  // namespace sharpctl::gui
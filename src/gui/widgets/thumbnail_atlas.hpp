@@ -0,0 +1,65 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <GL/gl.h>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace sharpctl::gui {
+
+// One texture holding many thumbnails in a grid of fixed-size cells, so a
+// strip of thumbnails draws from a single texture (one draw call) instead of
+// one texture each. Thumbnails are uploaded into a cell on demand; when the
+// atlas is full the least recently drawn cell is reused.
+class ThumbnailAtlas {
+public:
+    static constexpr int kAtlasWidth = 2048;
+    static constexpr int kAtlasHeight = 4096;  // 256 cells
+    static constexpr int kCellWidth = 256;
+    static constexpr int kCellHeight = 128;
+
+    // Texture coordinates and pixel size of a stored thumbnail
+    struct Slot {
+        float u0 = 0.0f, v0 = 0.0f;
+        float u1 = 0.0f, v1 = 0.0f;
+        int width = 0;
+        int height = 0;
+    };
+
+    ThumbnailAtlas();
+    ~ThumbnailAtlas();
+
+    ThumbnailAtlas(const ThumbnailAtlas&) = delete;
+    ThumbnailAtlas& operator=(const ThumbnailAtlas&) = delete;
+
+    // Look up the thumbnail stored for `key` and mark it as used
+    bool find(int key, Slot& outSlot);
+
+    // Upload a thumbnail (8-bit gray, BGR or BGRA) for `key`, shrinking it
+    // to fit a cell
+    void add(int key, const cv::Mat& thumbnail);
+
+    // Forget all thumbnails (the texture is kept)
+    void clear();
+
+    GLuint getTextureID() const { return textureID_; }
+    int getCapacity() const { return static_cast<int>(cells_.size()); }
+
+private:
+    struct Cell {
+        int key = -1;
+        uint64_t lastUse = 0;
+        int width = 0;
+        int height = 0;
+    };
+
+    Slot slotOf(size_t cell) const;
+
+    GLuint textureID_ = 0;
+    std::vector<Cell> cells_;
+    std::unordered_map<int, size_t> cellOfKey_;
+    uint64_t useClock_ = 0;
+};
+
+}  // namespace sharpctl::gui
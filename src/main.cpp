@@ -5,8 +5,12 @@
 #include <string>
 #include <vector>
 #include <cstring>
+#include <cstdlib>
 
 #include "core/video_analyzer.hpp"
+#include "core/frame_pool.hpp"
+#include "core/image_sequence_source.hpp"
+#include "core/video_capture_source.hpp"
 
 #ifdef SHARPCTL_GUI_ENABLED
 #include "gui/app.hpp"
@@ -21,6 +25,12 @@ sharpctl::SharpnessAlgorithm parseAlgorithm(const std::string& name) {
     return sharpctl::SharpnessAlgorithm::FFT;
 }
 
+sharpctl::ExportFormat parseFormat(const std::string& name) {
+    if (name == "png") return sharpctl::ExportFormat::PNG;
+    if (name == "tiff" || name == "tif") return sharpctl::ExportFormat::TIFF;
+    return sharpctl::ExportFormat::JPEG;
+}
+
 }  // anonymous namespace
 
 // CLI mode implementation
@@ -28,6 +38,13 @@ int runCli(int argc, char** argv) {
     // Parse flags
     bool showPlot = false;
     sharpctl::SharpnessAlgorithm algorithm = sharpctl::SharpnessAlgorithm::FFT;
+    int decodeReduction = 1;
+    sharpctl::ExportFormat format = sharpctl::ExportFormat::JPEG;
+    sharpctl::ScanMode scanMode = sharpctl::ScanMode::Full;
+    bool codecPrefilter = false;
+    bool background = false;
+    bool force8Bit = false;
+    int cpuCapPercent = 100;
     std::vector<char*> args;
 
     for (int i = 0; i < argc; ++i) {
@@ -35,6 +52,20 @@ int runCli(int argc, char** argv) {
             showPlot = true;
         } else if (std::strncmp(argv[i], "--algorithm=", 12) == 0) {
             algorithm = parseAlgorithm(argv[i] + 12);
+        } else if (std::strcmp(argv[i], "--prefilter") == 0) {
+            codecPrefilter = true;
+        } else if (std::strcmp(argv[i], "--keyframes") == 0) {
+            scanMode = sharpctl::ScanMode::Keyframes;
+        } else if (std::strncmp(argv[i], "--reduce=", 9) == 0) {
+            decodeReduction = std::atoi(argv[i] + 9);
+        } else if (std::strncmp(argv[i], "--format=", 9) == 0) {
+            format = parseFormat(argv[i] + 9);
+        } else if (std::strcmp(argv[i], "--background") == 0) {
+            background = true;
+        } else if (std::strcmp(argv[i], "--8bit") == 0) {
+            force8Bit = true;
+        } else if (std::strncmp(argv[i], "--cpu-cap=", 10) == 0) {
+            cpuCapPercent = std::atoi(argv[i] + 10);
         } else if (std::strcmp(argv[i], "--cli") != 0) {
             args.push_back(argv[i]);
         }
@@ -43,11 +74,25 @@ int runCli(int argc, char** argv) {
     if (args.size() < 4) {
         std::cerr
             << "Usage:\n  " << args[0]
-            << " <video_file> <output_folder> <target_interval_sec>"
-               " [search_window_sec=0.5] [search_step_sec=0.02] [--plot] [--algorithm=<name>]\n\n"
+            << " <video_file|image_dir> <output_folder> <target_interval_sec>"
+               " [search_window_sec=0.5] [search_step_sec=0.02] [--plot] [--algorithm=<name>]"
+               " [--reduce=<1|2|4|8>] [--format=<jpg|png|tiff>] [--keyframes] [--prefilter]"
+               " [--background] [--cpu-cap=<percent>] [--8bit]\n\n"
             << "Algorithms:\n"
             << "  fft       - FFT-based (default, slower, higher quality)\n"
             << "  laplacian - Laplacian variance (faster, lower quality)\n\n"
+            << "Image directories are read as a frame sequence at "
+            << sharpctl::ImageSequenceSource::kDefaultFps << " fps (natural filename order).\n"
+            << "--reduce scores on luma downscaled by the given factor (frames larger than 720p\n"
+            << "  are scored at the coarser scale that fits, so the luma cache can hold them).\n"
+            << "--format=png/tiff keeps 16 bits per channel for high bit depth sources.\n"
+            << "--keyframes only decodes keyframes (fast, coarse selection for long videos).\n"
+            << "--prefilter skips high-motion / high-QP frames using codec side data"
+            << (sharpctl::codecSideDataAvailable() ? "" : " (unavailable: built without FFmpeg)") << ".\n"
+            << "--background runs at low CPU and I/O priority.\n"
+            << "--cpu-cap pauses workers between frames to use about that share of the CPU.\n"
+            << "--8bit decodes video files through OpenCV at 8 bits, e.g. to compare the decode\n"
+            << "  rate of 10/12-bit video with its 16-bit path.\n\n"
             << "Example:\n  " << args[0] << " input.mp4 out 3 0.5 0.01 --plot --algorithm=fft\n";
         return 1;
     }
@@ -66,12 +111,30 @@ int runCli(int argc, char** argv) {
         std::cerr << "Error: search_window_sec must be >= 0 and search_step_sec must be > 0\n";
         return 1;
     }
+    if (decodeReduction != 1 && decodeReduction != 2 && decodeReduction != 4 && decodeReduction != 8) {
+        std::cerr << "Error: --reduce must be 1, 2, 4 or 8\n";
+        return 1;
+    }
+    if (cpuCapPercent < sharpctl::DutyCycle::kMinPercent || cpuCapPercent > 100) {
+        std::cerr << "Error: --cpu-cap must be between " << sharpctl::DutyCycle::kMinPercent << " and 100\n";
+        return 1;
+    }
+    if (background && !sharpctl::lowerThreadPriority()) {
+        std::cerr << "Warning: could not lower CPU/I/O priority\n";
+    }
 
     fs::create_directories(outDir);
 
     sharpctl::VideoAnalyzer analyzer;
-    if (!analyzer.openVideo(videoPath)) {
-        std::cerr << "Error: Could not open video file\n";
+    bool opened = false;
+    if (force8Bit && !fs::is_directory(videoPath)) {
+        auto source = std::make_unique<sharpctl::VideoCaptureSource>();
+        opened = source->open(videoPath) && analyzer.openSource(std::move(source));
+    } else {
+        opened = analyzer.openVideo(videoPath);
+    }
+    if (!opened) {
+        std::cerr << "Error: Could not open video file or image directory\n";
         return 1;
     }
 
@@ -81,35 +144,56 @@ int runCli(int argc, char** argv) {
     if (durationSec <= 0.0) {
         std::cerr << "Warning: duration unknown (FPS/frame count not reliable). Will sample until seeks fail.\n";
     }
+    if (scanMode == sharpctl::ScanMode::Keyframes && !analyzer.hasKeyframes()) {
+        std::cerr << "Warning: no keyframe flags, --keyframes samples every search step instead\n";
+    }
 
     sharpctl::AnalysisParams params;
     params.intervalSec = static_cast<float>(targetIntervalSec);
     params.searchWindowSec = searchWindowSec;
     params.searchStepSec = searchStepSec;
     params.algorithm = algorithm;
+    params.decodeReduction = decodeReduction;
+    params.scanMode = scanMode;
+    params.codecPrefilter = codecPrefilter;
+    params.cpuCapPercent = cpuCapPercent;
+    params.lowPriority = background;
 
     std::vector<sharpctl::FrameData> allSamples;
     std::vector<sharpctl::FrameData> selectedFrames;
 
+    // Print each decode schedule before it runs
+    analyzer.setPlanCallback([](const sharpctl::DecodePlan& plan, int threads) {
+        std::cout << plan.summary(threads) << "\n";
+    });
+
     // Find optimal frames
     analyzer.findOptimalFrames(params, allSamples, selectedFrames,
         [](float progress, const std::string& status) {
             // Progress callback (could add progress bar here)
         });
 
+    // Totals over every pass on this video, not just the last one
+    const sharpctl::VideoAnalyzer::Throughput throughput = analyzer.getTotalThroughput();
+    std::cout << "Decoded " << throughput.frames << " frames in " << throughput.seconds << "s ("
+              << throughput.framesPerSec() << " frames/s, " << videoInfo.bitDepth << "-bit luma";
+    if (throughput.cpuCapPercent < 100) {
+        std::cout << ", CPU cap " << throughput.cpuCapPercent << "%";
+    }
+    std::cout << ")\n";
+
     // Export frames
+    std::unique_ptr<sharpctl::DecoderHandle> decoder = analyzer.openDecoder(sharpctl::DecoderUse::Export);
     int outIndex = 0;
     for (const auto& frameData : selectedFrames) {
         cv::Mat frame;
-        if (analyzer.getFrameAt(frameData.time, frame)) {
-            char filename[512];
-            std::snprintf(filename, sizeof(filename),
-                          "frame_%04d_t%.3f_var%.2f.jpg",
-                          outIndex, frameData.time, frameData.sharpness);
-
-            const fs::path outPath = fs::path(outDir) / filename;
+        const bool ok = decoder && (frameData.frameIndex >= 0 ? decoder->getFrame(frameData.frameIndex, frame)
+                                                              : decoder->getFrameAt(frameData.time, frame));
+        if (ok) {
+            const fs::path outPath = fs::path(outDir) /
+                sharpctl::VideoAnalyzer::exportFilename(outIndex, frameData, format);
 
-            if (!cv::imwrite(outPath.string(), frame)) {
+            if (!sharpctl::VideoAnalyzer::writeFrame(outPath.string(), frame, format)) {
                 std::cerr << "Error: failed writing " << outPath.string() << "\n";
                 return 1;
             }
@@ -165,6 +249,9 @@ int runGui() {
 #endif
 
 int main(int argc, char** argv) {
+    // Recycle frame buffers instead of going to the heap for every decoded frame
+    sharpctl::FramePool::install();
+
     // Check for --cli flag or if arguments are provided (CLI mode)
     bool cliMode = false;
 
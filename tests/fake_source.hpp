@@ -0,0 +1,97 @@
+#pragma once
+
+#include "core/frame_source.hpp"
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+namespace sharpctl::test {
+
+// Synthetic long-GOP input: a keyframe every `gop` frames, frame i showing a
+// checkerboard blurred by blurOf(i) pixels (0 = sharp). Counts seeks and
+// decoded frames across clones; a seek decodes from the keyframe like a
+// real decoder would. Frames are 64x64 unless another size is given.
+class FakeSource : public FrameSource {
+public:
+    struct Counters {
+        std::atomic<int> seeks{0};
+        std::atomic<long long> decoded{0};
+    };
+
+    FakeSource(int frameCount, int gop, std::function<int(int)> blurOf = nullptr, int width = 64,
+               int height = 64)
+        : gop_(gop), blurOf_(std::move(blurOf)), counters_(std::make_shared<Counters>()) {
+        info_.path = "fake";
+        info_.fps = 25.0;
+        info_.frameCount = frameCount;
+        info_.width = width;
+        info_.height = height;
+        info_.duration = frameCount / info_.fps;
+    }
+
+    bool open(const std::string&) override { return true; }
+    void close() override {}
+    bool isOpen() const override { return true; }
+    const VideoInfo& getInfo() const override { return info_; }
+
+    std::unique_ptr<FrameSource> clone() const override { return std::make_unique<FakeSource>(*this); }
+
+    bool seekFrame(int index) override {
+        if (index < 0 || index >= info_.frameCount) return false;
+        counters_->seeks++;
+        counters_->decoded += index - keyframeAtOrBefore(index);
+        position_ = index;
+        return true;
+    }
+    int getPosition() const override { return position_; }
+
+    bool readFrame(cv::Mat& outFrame) override {
+        if (position_ >= info_.frameCount) return false;
+        cv::Mat board(info_.height, info_.width, CV_8UC3);
+        for (int y = 0; y < board.rows; ++y) {
+            for (int x = 0; x < board.cols; ++x) {
+                const uchar v = ((x / 4 + y / 4) % 2) ? 230 : 25;
+                board.at<cv::Vec3b>(y, x) = cv::Vec3b(v, v, v);
+            }
+        }
+        const int blur = blurOf_ ? blurOf_(position_) : 0;
+        if (blur > 0) {
+            cv::GaussianBlur(board, outFrame, cv::Size(), blur);
+        } else {
+            outFrame = board;
+        }
+        counters_->decoded++;
+        position_++;
+        return true;
+    }
+
+    bool skipFrame() override {
+        if (position_ >= info_.frameCount) return false;
+        counters_->decoded++;
+        position_++;
+        return true;
+    }
+
+    int keyframeAtOrBefore(int index) const override { return gop_ > 1 ? index - index % gop_ : index; }
+
+    std::vector<int> keyframes() const override {
+        std::vector<int> result;
+        for (int i = 0; gop_ > 1 && i < info_.frameCount; i += gop_) {
+            result.push_back(i);
+        }
+        return result;
+    }
+
+    const Counters& counters() const { return *counters_; }
+
+private:
+    VideoInfo info_;
+    int gop_;
+    std::function<int(int)> blurOf_;
+    std::shared_ptr<Counters> counters_;  // Shared with clones
+    int position_ = 0;
+};
+
+}  // namespace sharpctl::test
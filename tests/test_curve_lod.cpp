@@ -0,0 +1,82 @@
+#include "gui/widgets/curve_lod.hpp"
+#include "test_common.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace sharpctl::gui;
+
+namespace {
+
+struct Curve {
+    std::vector<double> x, y;
+};
+
+// Decimated output is drawable as a line and keeps the extremes of the range
+void checkDecimated(const Curve& curve, const CurveLod& lod, double xMin, double xMax, int maxPoints) {
+    std::vector<double> outX, outY;
+    lod.decimate(xMin, xMax, maxPoints, outX, outY);
+    CHECK(!outX.empty() && outX.size() == outY.size());
+    CHECK(outX.size() <= static_cast<size_t>(2 * maxPoints));
+    CHECK(std::is_sorted(outX.begin(), outX.end()));
+    CHECK(outX.front() <= xMin && outX.back() >= xMax);
+
+    double visibleMin = INFINITY, visibleMax = -INFINITY;
+    for (size_t i = 0; i < curve.x.size(); ++i) {
+        if (curve.x[i] >= xMin && curve.x[i] <= xMax) {
+            visibleMin = std::min(visibleMin, curve.y[i]);
+            visibleMax = std::max(visibleMax, curve.y[i]);
+        }
+    }
+    CHECK(std::find(outY.begin(), outY.end(), visibleMax) != outY.end());
+    CHECK(std::find(outY.begin(), outY.end(), visibleMin) != outY.end());
+}
+
+}  // anonymous namespace
+
+int main() {
+    // An odd-sized curve (incomplete buckets at every level) with one spike and one dip
+    Curve curve;
+    CurveLod lod;
+    for (int i = 0; i < 10001; ++i) {
+        const double x = i * 0.1;
+        double y = 50.0 + 10.0 * std::sin(i * 0.01);
+        if (i == 4321) y = 500.0;
+        if (i == 7777) y = -20.0;
+        curve.x.push_back(x);
+        curve.y.push_back(y);
+        lod.append(x, y);
+    }
+    CHECK(lod.size() == curve.x.size());
+    CHECK(lod.getMaxY() == 500.0);
+
+    // Whole curve, zoomed ranges and a range ending in the incomplete tail
+    checkDecimated(curve, lod, 0.0, 1000.0, 300);
+    checkDecimated(curve, lod, 400.0, 800.0, 100);
+    checkDecimated(curve, lod, 432.0, 433.0, 100);
+    checkDecimated(curve, lod, 950.0, 1000.0, 16);
+
+    // Few enough points come back raw, with one neighbour on either side
+    {
+        std::vector<double> outX, outY;
+        lod.decimate(10.0, 11.0, 100, outX, outY);
+        CHECK(outX.size() == 13);
+        CHECK(outX.front() == curve.x[99] && outX.back() == curve.x[111]);
+        CHECK(outY[1] == curve.y[100]);
+    }
+
+    // Ranges outside the curve still reach its nearest point
+    {
+        std::vector<double> outX, outY;
+        lod.decimate(2000.0, 3000.0, 100, outX, outY);
+        CHECK(outX.size() == 1 && outX[0] == curve.x.back());
+    }
+
+    lod.clear();
+    CHECK(lod.size() == 0 && lod.getMaxY() == 0.0);
+    std::vector<double> outX, outY;
+    lod.decimate(0.0, 1.0, 100, outX, outY);
+    CHECK(outX.empty());
+
+    return 0;
+}
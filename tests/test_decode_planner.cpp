@@ -0,0 +1,95 @@
+#include "core/decode_planner.hpp"
+#include "fake_source.hpp"
+#include "test_common.hpp"
+
+using namespace sharpctl;
+
+namespace {
+
+constexpr DecodeCosts kCosts{5.0, 20.0};
+
+// Runs are in order, non-empty and cover every needed frame exactly once
+void checkRuns(const DecodePlan& plan) {
+    size_t next = 0;
+    for (const DecodeRun& run : plan.runs) {
+        CHECK(run.begin == next && run.end > run.begin);
+        next = run.end;
+    }
+    CHECK(next == plan.frames.size());
+}
+
+}  // anonymous namespace
+
+int main() {
+    test::FakeSource source(2000, 100);
+
+    // Needed frames come out sorted and unique, without negative indices
+    {
+        const DecodePlan plan = planDecode({7, 3, 7, -1, 5}, source, kCosts);
+        CHECK((plan.frames == std::vector<int>{3, 5, 7}));
+        CHECK(plan.slotOf(5) == 1);
+        CHECK(plan.slotOf(7) == 2);
+        CHECK(planDecode({}, source, kCosts).runs.empty());
+    }
+
+    // Frames within one GOP decode forward after a single seek
+    {
+        const DecodePlan plan = planDecode({10, 12, 15}, source, kCosts);
+        checkRuns(plan);
+        CHECK(plan.runs.size() == 1);
+        CHECK(plan.seeks == 1);
+        CHECK(plan.decodedFrames == 16);  // Keyframe 0 up to 15
+        CHECK(plan.estimatedMs == 16 * kCosts.decodeMs + kCosts.seekMs);
+    }
+
+    // Far-apart frames each get their own seek to the nearest keyframe
+    {
+        const DecodePlan plan = planDecode({5, 505, 1005}, source, kCosts);
+        checkRuns(plan);
+        CHECK(plan.runs.size() == 3);
+        CHECK(plan.seeks == 3);
+        CHECK(plan.decodedFrames == 18);
+        CHECK(plan.estimatedMs <= plan.seekEachFrameMs);
+    }
+
+    // Crossing a keyframe by a few frames is cheaper than seeking
+    {
+        const DecodePlan plan = planDecode({95, 105}, source, kCosts);
+        checkRuns(plan);
+        CHECK(plan.seeks == 1);
+        CHECK(plan.decodedFrames == 106);
+    }
+
+    // A dense run is split at keyframes so every worker gets a share,
+    // without decoding anything twice
+    {
+        std::vector<int> frames;
+        for (int i = 0; i < 400; ++i) frames.push_back(i);
+        const DecodePlan plan = planDecode(frames, source, kCosts, 4);
+        checkRuns(plan);
+        CHECK(plan.runs.size() == 4);
+        CHECK(plan.seeks == 4);
+        CHECK(plan.decodedFrames == 400);
+        for (const DecodeRun& run : plan.runs) {
+            CHECK(source.keyframeAtOrBefore(plan.frames[run.begin]) == plan.frames[run.begin]);
+        }
+    }
+
+    // Without keyframes every frame is a seek point
+    {
+        test::FakeSource intra(2000, 1);
+        const DecodePlan plan = planDecode({0, 50, 51}, intra, kCosts);
+        checkRuns(plan);
+        CHECK(plan.runs.size() == 2);
+        CHECK(plan.decodedFrames == 3);
+    }
+
+    // Measured costs are positive
+    {
+        const DecodeCosts measured = measureDecodeCosts(source);
+        CHECK(measured.decodeMs > 0.0);
+        CHECK(measured.seekMs >= 0.0);
+    }
+
+    return 0;
+}
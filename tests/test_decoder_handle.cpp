@@ -0,0 +1,50 @@
+#include "core/decoder_handle.hpp"
+#include "fake_source.hpp"
+#include "test_common.hpp"
+
+#include <memory>
+
+using namespace sharpctl;
+
+namespace {
+
+// Input whose handles cannot be cloned (e.g. the file went away)
+class UnclonableSource : public test::FakeSource {
+public:
+    using test::FakeSource::FakeSource;
+    std::unique_ptr<FrameSource> clone() const override { return nullptr; }
+};
+
+}  // anonymous namespace
+
+int main() {
+    auto stats = std::make_shared<DecoderStats>();
+
+    // Only seeks that succeed and move the position count
+    {
+        DecoderHandle handle(std::make_unique<test::FakeSource>(100, 10), stats);
+        CHECK(handle.seekFrame(20));
+        CHECK(stats->get().seeks == 1);
+        CHECK(handle.seekFrame(20));
+        CHECK(stats->get().seeks == 1);
+        CHECK(!handle.seekFrame(500));
+        CHECK(stats->get().seeks == 1);
+
+        cv::Mat frame;
+        CHECK(handle.readFrame(frame) && handle.getPosition() == 21);
+        CHECK(stats->get().frames == 1);
+
+        // Clones count towards the same statistics
+        std::unique_ptr<FrameSource> copy = handle.clone();
+        CHECK(copy && copy->seekFrame(50));
+        CHECK(stats->get().seeks == 2);
+    }
+
+    // A handle on an input that cannot be cloned has no clone either
+    {
+        DecoderHandle handle(std::make_unique<UnclonableSource>(100, 10), stats);
+        CHECK(handle.clone() == nullptr);
+    }
+
+    return 0;
+}
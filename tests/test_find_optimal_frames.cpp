@@ -0,0 +1,58 @@
+#include "core/video_analyzer.hpp"
+#include "fake_source.hpp"
+#include "test_common.hpp"
+
+#include <algorithm>
+#include <memory>
+
+using namespace sharpctl;
+
+namespace {
+
+// One sharp frame in each 4 s window (25 fps), off the window centre, so
+// picking by a frame's position within its window instead of its own score
+// gives other frames
+const std::vector<int> kSharp = {5, 103, 210, 290, 398, 495};
+
+int blurOf(int frame) {
+    return std::find(kSharp.begin(), kSharp.end(), frame) != kSharp.end() ? 0 : 3;
+}
+
+}  // anonymous namespace
+
+int main() {
+    VideoAnalyzer analyzer;
+    CHECK(analyzer.openSource(std::make_unique<test::FakeSource>(500, 50, blurOf)));
+
+    AnalysisParams params;
+    params.algorithm = SharpnessAlgorithm::Laplacian;
+    params.intervalSec = 4.0f;
+    params.searchWindowSec = 0.5f;
+    params.searchStepSec = 0.04f;  // Every frame
+
+    // Each window picks its own sharp frame, selected and with a thumbnail;
+    // the rerun scores from the luma cache and must agree
+    for (int run = 0; run < 2; ++run) {
+        std::vector<FrameData> selected;
+        CHECK(analyzer.findOptimalFrames(params, {}, selected));
+        CHECK(selected.size() == kSharp.size());
+        for (size_t i = 0; i < selected.size(); ++i) {
+            CHECK(selected[i].frameIndex == kSharp[i]);
+            CHECK(selected[i].time == kSharp[i] / 25.0);
+            CHECK(selected[i].selected && !selected[i].thumbnail.empty());
+        }
+    }
+    CHECK(analyzer.getLumaCacheStats().hits > 0);
+    CHECK(analyzer.scoringReductionFor(1) == 1);
+
+    // Frames larger than 720p are scored at the scale that keeps them cached
+    VideoAnalyzer large;
+    CHECK(large.openSource(std::make_unique<test::FakeSource>(10, 5, nullptr, 1920, 1080)));
+    CHECK(large.scoringReductionFor(1) == 2);
+    CHECK(large.scoringReductionFor(4) == 4);
+    CHECK(large.openSource(std::make_unique<test::FakeSource>(10, 5, nullptr, 3840, 2160)));
+    CHECK(large.scoringReductionFor(1) == 4);
+    CHECK(large.scoringReductionFor(2) == 4);
+
+    return 0;
+}
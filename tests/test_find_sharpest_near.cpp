@@ -0,0 +1,76 @@
+#include "core/video_analyzer.hpp"
+#include "fake_source.hpp"
+#include "test_common.hpp"
+
+#include <cmath>
+
+using namespace sharpctl;
+
+namespace {
+
+constexpr double kFps = 25.0;
+
+// Blurred everywhere except three identical sharp frames
+int blurOf(int frame) {
+    return (frame == 3 || frame == 108 || frame == 112) ? 0 : 3;
+}
+
+}  // anonymous namespace
+
+int main() {
+    VideoAnalyzer analyzer;
+    AnalysisParams params;
+    params.algorithm = SharpnessAlgorithm::Laplacian;
+    const std::unordered_map<int, double> none;
+
+    // The sharpest frame of the window is returned selected, with its thumbnail
+    {
+        test::FakeSource source(250, 50, blurOf);
+        FrameData out;
+        CHECK(analyzer.findSharpestNear(source, params, 112 / kFps, 0.08, none, out));
+        CHECK(out.frameIndex == 112);
+        CHECK(std::abs(out.time - 112 / kFps) < 1e-9);
+        CHECK(out.selected && !out.thumbnail.empty() && out.sharpness > 0.0);
+
+        // One seek into the window, one back to the winner
+        CHECK(source.counters().seeks == 2);
+    }
+
+    // Ties go to the earliest frame; a zero window returns the frame itself
+    {
+        test::FakeSource source(250, 50, blurOf);
+        FrameData out;
+        CHECK(analyzer.findSharpestNear(source, params, 110 / kFps, 0.2, none, out));
+        CHECK(out.frameIndex == 108);
+        CHECK(analyzer.findSharpestNear(source, params, 110 / kFps, 0.0, none, out));
+        CHECK(out.frameIndex == 110);
+    }
+
+    // Luma scored before comes from the cache: only the winner is decoded
+    {
+        test::FakeSource source(250, 50, blurOf);
+        FrameData out;
+        CHECK(analyzer.findSharpestNear(source, params, 112 / kFps, 0.08, none, out));
+        CHECK(out.frameIndex == 112);
+        CHECK(source.counters().decoded == 112 - 100 + 1);
+    }
+
+    // Known scores are used as given
+    {
+        test::FakeSource source(250, 50, blurOf);
+        FrameData out;
+        const std::unordered_map<int, double> known{{113, 1e12}};
+        CHECK(analyzer.findSharpestNear(source, params, 112 / kFps, 0.08, known, out));
+        CHECK(out.frameIndex == 113 && out.sharpness == 1e12);
+    }
+
+    // Windows are clamped to the start of the input
+    {
+        test::FakeSource source(250, 50, blurOf);
+        FrameData out;
+        CHECK(analyzer.findSharpestNear(source, params, 0.02, 0.2, none, out));
+        CHECK(out.frameIndex == 3);
+    }
+
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include "core/frame_index.hpp"
+#include "test_common.hpp"
+
+#include <opencv2/opencv.hpp>
+#include <cmath>
+#include <fstream>
+
+using namespace sharpctl;
+
+namespace {
+
+constexpr int kFrames = 30;
+constexpr double kFps = 10.0;
+
+// Short all-intra MJPEG clip, which OpenCV can write without external codecs
+bool writeClip(const std::string& path) {
+    cv::VideoWriter writer(path, cv::VideoWriter::fourcc('M', 'J', 'P', 'G'), kFps, cv::Size(64, 48));
+    if (!writer.isOpened()) return false;
+    for (int i = 0; i < kFrames; ++i) {
+        cv::Mat frame(48, 64, CV_8UC3, cv::Scalar(i * 8, 255 - i * 8, 128));
+        writer.write(frame);
+    }
+    return true;
+}
+
+bool sameIndex(const FrameIndex& a, const FrameIndex& b) {
+    if (a.frameCount() != b.frameCount() || a.keyframes() != b.keyframes()) return false;
+    for (int i = 0; i < a.frameCount(); ++i) {
+        if (a.timeOfFrame(i) != b.timeOfFrame(i)) return false;
+    }
+    return true;
+}
+
+}  // anonymous namespace
+
+int main() {
+    test::TempDir dir("frame_index");
+    const std::string video = dir.file("clip.avi");
+    if (!writeClip(video)) {
+        std::fprintf(stderr, "no MJPEG writer, skipped\n");
+        return test::kSkipped;
+    }
+
+    FrameIndex built;
+    CHECK(built.build(video));
+    CHECK(built.frameCount() == kFrames);
+    for (int i = 0; i < kFrames; ++i) {
+        CHECK(std::abs(built.timeOfFrame(i) - built.timeOfFrame(0) - i / kFps) < 1e-3);
+        CHECK(built.frameAtTime(built.timeOfFrame(i)) == i);
+    }
+    if (built.hasKeyframes()) {
+        // All-intra: every frame is a seek point and costs one decode
+        CHECK(built.keyframeAtOrBefore(17) == 17);
+        bool needsSeek = false;
+        CHECK(built.framesToDecode(3, 17, &needsSeek) == 1 && needsSeek);
+        CHECK(built.framesToDecode(17, 17, &needsSeek) == 1 && !needsSeek);
+    }
+
+    // Round trip through the cache file
+    const std::string indexPath = dir.file("clip.avi.index");
+    CHECK(built.save(indexPath, video));
+    FrameIndex loaded;
+    CHECK(loaded.load(indexPath, video));
+    CHECK(sameIndex(built, loaded));
+
+    // A truncated or padded cache is rejected
+    const auto size = std::filesystem::file_size(indexPath);
+    std::filesystem::resize_file(indexPath, size - 4);
+    CHECK(!loaded.load(indexPath, video));
+    CHECK(loaded.empty());
+    std::filesystem::resize_file(indexPath, size + 8);
+    CHECK(!loaded.load(indexPath, video));
+
+    // So is the cache of a video that has changed since
+    CHECK(built.save(indexPath, video));
+    std::ofstream(video, std::ios::binary | std::ios::app).put('\0');
+    CHECK(!loaded.load(indexPath, video));
+
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include "core/interactive_gate.hpp"
+#include "test_common.hpp"
+
+#include <chrono>
+#include <thread>
+#include <utility>
+
+using namespace sharpctl;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+}  // anonymous namespace
+
+int main() {
+    const double maxYieldMs = static_cast<double>(InteractiveGate::kMaxYield.count());
+
+    // Without tickets a yield is free and not counted
+    {
+        InteractiveGate gate;
+        CHECK(!gate.isBusy());
+        gate.yield();
+        CHECK(gate.getStats().yields == 0);
+    }
+
+    // Tickets count while alive; moving one hands it over, release() ends it early
+    {
+        InteractiveGate gate;
+        InteractiveGate::Ticket a = gate.enter();
+        {
+            InteractiveGate::Ticket b = gate.enter();
+            InteractiveGate::Ticket moved = std::move(b);
+            b.release();  // Moved-from: no effect
+            CHECK(gate.isBusy());
+            a.release();
+            CHECK(gate.isBusy());
+        }
+        CHECK(!gate.isBusy());
+
+        InteractiveGate::Ticket c = gate.enter();
+        c = InteractiveGate::Ticket();  // Assigning releases the old ticket
+        CHECK(!gate.isBusy());
+    }
+
+    // A yield waits for the interactive work to finish
+    {
+        InteractiveGate gate;
+        InteractiveGate::Ticket ticket = gate.enter();
+        std::thread interactive([&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(30));
+            ticket.release();
+        });
+        const auto start = Clock::now();
+        gate.yield();
+        const double waited = msSince(start);
+        interactive.join();
+
+        CHECK(waited >= 25.0);
+        CHECK(waited < maxYieldMs);
+        CHECK(gate.getStats().yields == 1);
+        CHECK(gate.getStats().yieldedMs >= 25.0);
+    }
+
+    // ...but never longer than kMaxYield
+    {
+        InteractiveGate gate;
+        InteractiveGate::Ticket ticket = gate.enter();
+        const auto start = Clock::now();
+        gate.yield();
+        const double waited = msSince(start);
+        CHECK(waited >= maxYieldMs - 1.0);
+        CHECK(waited < maxYieldMs * 2.0);
+        CHECK(gate.isBusy());
+    }
+
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include "core/luma_cache.hpp"
+#include "test_common.hpp"
+
+#include <opencv2/opencv.hpp>
+
+using namespace sharpctl;
+
+namespace {
+
+bool same(const cv::Mat& a, const cv::Mat& b) {
+    return a.size() == b.size() && a.type() == b.type() && cv::norm(a, b, cv::NORM_INF) == 0.0;
+}
+
+// Incompressible frame, so it is stored at its raw size with or without LZ4
+cv::Mat noise(int rows, int cols, int type) {
+    cv::Mat frame(rows, cols, type);
+    cv::randu(frame, cv::Scalar::all(0), cv::Scalar::all(type == CV_16UC1 ? 65535 : 255));
+    return frame;
+}
+
+}  // anonymous namespace
+
+int main() {
+    // Round trips: smooth and noisy, 8-bit and 16-bit, and a non-continuous ROI
+    {
+        LumaCache cache;
+        cv::Mat smooth(90, 160, CV_8UC1);
+        for (int y = 0; y < smooth.rows; ++y) {
+            smooth.row(y).setTo(y);
+        }
+        const cv::Mat deep = noise(90, 160, CV_16UC1);
+        const cv::Mat wide = noise(100, 200, CV_8UC1);
+        const cv::Mat roi = wide(cv::Rect(10, 10, 50, 40));
+
+        cache.put({1, 2, 0}, smooth);
+        cache.put({2, 2, 0}, deep);
+        cache.put({3, 2, 0}, roi);
+
+        cv::Mat out;
+        CHECK(cache.get({1, 2, 0}, out) && same(out, smooth));
+        CHECK(cache.get({2, 2, 0}, out) && same(out, deep));
+        CHECK(cache.get({3, 2, 0}, out) && same(out, roi));
+
+        // Reduction and variant are part of the key
+        CHECK(!cache.get({1, 4, 0}, out));
+        CHECK(!cache.get({1, 2, 1}, out));
+
+        const LumaCache::Stats stats = cache.getStats();
+        CHECK(stats.entries == 3);
+        CHECK(stats.hits == 3);
+        CHECK(stats.misses == 2);
+        CHECK(stats.bytesRaw == smooth.total() + deep.total() * 2 + roi.total());
+        if (LumaCache::isCompressed()) {
+            CHECK(stats.bytesStored < stats.bytesRaw);
+        }
+    }
+
+    // contains() counts a miss (the caller decodes instead), not a hit
+    {
+        LumaCache cache;
+        cache.put({5, 1, 0}, noise(8, 8, CV_8UC1));
+        CHECK(cache.contains({5, 1, 0}));
+        CHECK(!cache.contains({6, 1, 0}));
+        const LumaCache::Stats stats = cache.getStats();
+        CHECK(stats.hits == 0 && stats.misses == 1);
+    }
+
+    // Least recently used frames are evicted to stay within the budget
+    {
+        const size_t frameBytes = 64 * 64;
+        LumaCache cache(frameBytes * 5 / 2);
+        cache.put({0, 1, 0}, noise(64, 64, CV_8UC1));
+        cache.put({1, 1, 0}, noise(64, 64, CV_8UC1));
+
+        cv::Mat out;
+        CHECK(cache.get({0, 1, 0}, out));  // Frame 1 is now the oldest
+        cache.put({2, 1, 0}, noise(64, 64, CV_8UC1));
+        CHECK(cache.contains({0, 1, 0}));
+        CHECK(!cache.contains({1, 1, 0}));
+        CHECK(cache.contains({2, 1, 0}));
+        CHECK(cache.getStats().bytesStored <= frameBytes * 5 / 2);
+
+        // Replacing a frame does not count it twice
+        cache.put({2, 1, 0}, noise(64, 64, CV_8UC1));
+        CHECK(cache.getStats().entries == 2);
+
+        // Frames larger than the whole budget are not stored
+        cache.put({3, 1, 0}, noise(128, 128, CV_8UC1));
+        CHECK(!cache.contains({3, 1, 0}));
+        CHECK(cache.getStats().entries == 2);
+
+        cache.clear();
+        const LumaCache::Stats stats = cache.getStats();
+        CHECK(stats.entries == 0 && stats.bytesStored == 0 && stats.misses == 0);
+    }
+
+    // Only luma up to 720p size is admitted
+    CHECK(LumaCache::admits(1280, 720));
+    CHECK(LumaCache::admits(960, 540));
+    CHECK(!LumaCache::admits(1920, 1080));
+
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include "core/throttle.hpp"
+#include "test_common.hpp"
+
+#include <chrono>
+
+#ifdef __linux__
+#include <sys/resource.h>
+#endif
+
+using namespace sharpctl;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+struct Timing {
+    double wallMs = 0.0;
+    double workMs = 0.0;  // As measured around each unit, including preemption
+};
+
+double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Run `units` busy units of `unit` each under a duty cycle
+Timing runCapped(int percent, int units, Clock::duration unit) {
+    DutyCycle duty(percent);
+    Timing timing;
+    const auto start = Clock::now();
+    for (int i = 0; i < units; ++i) {
+        duty.start();
+        const auto workStart = Clock::now();
+        while (Clock::now() < workStart + unit) {}
+        timing.workMs += msSince(workStart);
+        duty.finish();
+    }
+    timing.wallMs = msSince(start);
+    return timing;
+}
+
+}  // anonymous namespace
+
+int main() {
+    constexpr int kUnits = 20;
+    constexpr auto kUnit = std::chrono::milliseconds(5);
+
+    // Uncapped runs never sleep
+    CHECK(!DutyCycle(100).isActive());
+    CHECK(!DutyCycle(150).isActive());
+    const Timing full = runCapped(100, kUnits, kUnit);
+    CHECK(full.wallMs < full.workMs * 1.2 + 5.0);
+
+    // At p% the run rests (100 - p) / p of its work time; sleeps may
+    // overshoot, and up to one short sleep is still owed at the end
+    for (int percent : {50, 25}) {
+        const Timing capped = runCapped(percent, kUnits, kUnit);
+        const double expected = capped.workMs * 100.0 / percent;
+        CHECK(capped.wallMs >= expected - 2.0);
+        CHECK(capped.wallMs < expected * 1.2 + 10.0);
+    }
+
+    // Caps below the minimum are raised to it rather than stalling
+    CHECK(DutyCycle(0).isActive());
+    const Timing minimum = runCapped(0, 2, std::chrono::milliseconds(1));
+    CHECK(minimum.wallMs < minimum.workMs * 100.0 / DutyCycle::kMinPercent * 1.2 + 10.0);
+
+#ifdef __linux__
+    // A disabled scope leaves the priority alone; an enabled one lowers it
+    // (restoring it afterwards may need privileges, so that is not checked)
+    const int nice = getpriority(PRIO_PROCESS, 0);
+    {
+        LowPriorityScope scope(false);
+        CHECK(getpriority(PRIO_PROCESS, 0) == nice);
+    }
+    {
+        LowPriorityScope scope(true);
+        CHECK(getpriority(PRIO_PROCESS, 0) >= 10);
+    }
+#endif
+
+    return 0;
+}
@@ -0,0 +1,160 @@
+#include "core/y4m_source.hpp"
+#include "test_common.hpp"
+
+#include <opencv2/opencv.hpp>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+
+using namespace sharpctl;
+
+namespace {
+
+constexpr int kWidth = 8;
+constexpr int kHeight = 4;
+
+// Luma sample at (x, y) of frame `frame`
+int lumaAt(int frame, int x, int y) {
+    return frame * 40 + y * kWidth + x;
+}
+
+// Append one planar frame: luma from lumaAt() times `scale`, neutral chroma planes of
+// `chromaSamples` samples each; `wide` frames are 10-bit in 16-bit
+// little-endian words
+void writeFrame(std::ofstream& out, int frame, int chromaSamples, bool wide, int scale = 1) {
+    auto put = [&](int value) {
+        out.put(static_cast<char>(value & 0xff));
+        if (wide) out.put(static_cast<char>(value >> 8));
+    };
+    for (int y = 0; y < kHeight; ++y) {
+        for (int x = 0; x < kWidth; ++x) {
+            put(lumaAt(frame, x, y) * scale);
+        }
+    }
+    for (int i = 0; i < 2 * chromaSamples; ++i) {
+        put(wide ? 512 : 128);
+    }
+}
+
+void checkLuma(Y4mSource& source, int frame, int scale = 1) {
+    cv::Mat gray;
+    CHECK(source.seekFrame(frame));
+    CHECK(source.readLuma(gray));
+    CHECK(source.getPosition() == frame + 1);
+    CHECK(gray.rows == kHeight && gray.cols == kWidth);
+    for (int y = 0; y < kHeight; ++y) {
+        for (int x = 0; x < kWidth; ++x) {
+            const int value = gray.depth() == CV_16U ? gray.at<uint16_t>(y, x) : gray.at<uchar>(y, x);
+            CHECK(value == lumaAt(frame, x, y) * scale);
+        }
+    }
+}
+
+}  // anonymous namespace
+
+int main() {
+    test::TempDir dir("y4m");
+    const int chroma420 = (kWidth / 2) * (kHeight / 2);
+
+    // 8-bit 4:2:0 with frame parameters and a truncated last frame
+    {
+        const std::string path = dir.file("clip.y4m");
+        std::ofstream out(path, std::ios::binary);
+        out << "YUV4MPEG2 W" << kWidth << " H" << kHeight << " F30000:1001 Ip A1:1 C420jpeg XYSCSS=420JPEG\n";
+        for (int frame = 0; frame < 3; ++frame) {
+            out << (frame == 1 ? "FRAME Ip\n" : "FRAME\n");
+            writeFrame(out, frame, chroma420, false);
+        }
+        out << "FRAME\n";
+        out.put(0);
+        out.close();
+
+        Y4mSource source;
+        CHECK(source.open(path));
+        const VideoInfo& info = source.getInfo();
+        CHECK(info.width == kWidth && info.height == kHeight);
+        CHECK(info.frameCount == 3);
+        CHECK(info.bitDepth == 8);
+        CHECK(std::abs(info.fps - 30000.0 / 1001.0) < 1e-9);
+        checkLuma(source, 2);
+        checkLuma(source, 0);
+
+        cv::Mat bgr;
+        CHECK(source.seekFrame(1) && source.readFrame(bgr));
+        CHECK(bgr.type() == CV_8UC3 && bgr.rows == kHeight && bgr.cols == kWidth);
+
+        // Clones read independently from the same mapping
+        auto clone = source.clone();
+        CHECK(clone->seekFrame(1));
+        CHECK(source.getPosition() == 2);
+        CHECK(!source.seekFrame(3));
+    }
+
+    // 10-bit samples come through unscaled as 16-bit luma
+    {
+        const std::string path = dir.file("deep.y4m");
+        std::ofstream out(path, std::ios::binary);
+        out << "YUV4MPEG2 W" << kWidth << " H" << kHeight << " F25:1 C420p10\n";
+        for (int frame = 0; frame < 2; ++frame) {
+            out << "FRAME\n";
+            writeFrame(out, frame, chroma420, true, 8);
+        }
+        out.close();
+
+        Y4mSource source;
+        CHECK(source.open(path));
+        CHECK(source.getInfo().bitDepth == 10);
+        CHECK(source.getInfo().frameCount == 2);
+        checkLuma(source, 1, 8);
+    }
+
+    // Monochrome has no chroma planes
+    {
+        const std::string path = dir.file("mono.y4m");
+        std::ofstream out(path, std::ios::binary);
+        out << "YUV4MPEG2 W" << kWidth << " H" << kHeight << " F24:1 Cmono\n";
+        for (int frame = 0; frame < 2; ++frame) {
+            out << "FRAME\n";
+            writeFrame(out, frame, 0, false);
+        }
+        out.close();
+
+        Y4mSource source;
+        CHECK(source.open(path));
+        CHECK(source.getInfo().frameCount == 2);
+        checkLuma(source, 1);
+    }
+
+    // Headerless .yuv takes its size from the name and the default rate
+    {
+        const std::string path = dir.file("raw_8x4.yuv");
+        std::ofstream out(path, std::ios::binary);
+        for (int frame = 0; frame < 2; ++frame) {
+            writeFrame(out, frame, chroma420, false);
+        }
+        out.close();
+
+        Y4mSource source;
+        CHECK(Y4mSource::isRawVideoFile(path));
+        CHECK(source.open(path));
+        CHECK(source.getInfo().frameCount == 2);
+        CHECK(source.getInfo().fps == Y4mSource::kRawYuvFps);
+        checkLuma(source, 1);
+    }
+
+    // Headers without a size or with an unsupported colorspace are rejected
+    {
+        const std::string noSize = dir.file("nosize.y4m");
+        std::ofstream(noSize, std::ios::binary) << "YUV4MPEG2 F25:1\nFRAME\n";
+        const std::string alpha = dir.file("alpha.y4m");
+        std::ofstream(alpha, std::ios::binary) << "YUV4MPEG2 W8 H4 C444alpha\nFRAME\n";
+
+        Y4mSource source;
+        CHECK(!source.open(noSize));
+        CHECK(!source.open(alpha));
+        CHECK(!source.open(dir.file("missing.y4m")));
+        CHECK(!source.isOpen());
+    }
+
+    return 0;
+}